@@ -3,7 +3,13 @@
 #include <cstdint>
 #include <vector>
 #include <array>
+#include <memory>
 #include <SDL2/SDL.h>
+#include "ring_buffer.hpp"
+#include "blip_buffer.hpp"
+#include "mixer.hpp"
+#include "resampler.hpp"
+#include "decimator.hpp"
 
 // =============================================================
 // PULSE CHANNEL
@@ -19,11 +25,13 @@ public:
     void setEnabled(bool e);
     
     void stepTimer();
+    void stepTimer(uint32_t clocks); // Same as `clocks` calls of stepTimer()
     void stepEnvelope();
     void stepLength();
     
     uint8_t getOutput();
     bool isEnabled() const { return enabled; }
+    bool sequencerAudible() const; // Whether a sequencer clock can change getOutput()
 
 public:
     bool enabled = false;
@@ -59,10 +67,12 @@ public:
     void setEnabled(bool e);
 
     void stepTimer();
+    void stepTimer(uint32_t clocks); // Same as `clocks` calls of stepTimer()
     void stepLength();
     void stepLinearCounter();
 
     uint8_t getOutput();
+    bool sequencerAudible() const; // Whether a sequencer clock can change getOutput()
 
 public:
     bool enabled = false;
@@ -98,10 +108,12 @@ public:
     void setEnabled(bool e);
 
     void stepTimer();
+    void stepTimer(uint32_t clocks); // Same as `clocks` calls of stepTimer()
     void stepEnvelope();
     void stepLength();
 
     uint8_t getOutput();
+    bool sequencerAudible() const; // Whether an LFSR shift can change getOutput()
 
 public:
     bool enabled = false;
@@ -143,13 +155,70 @@ public:
 
     // Clocking
     void step(int cycles); // Runs at CPU frequency
+    int cyclesUntilFrameIRQ() const; // Cycles step() runs before the frame IRQ fires
+
+    // How step() advances the units: timers in closed form between events
+    // (BATCH) or every unit every CPU cycle (CYCLE, the reference). Both
+    // produce the same samples; APU_STEP=cycle makes CYCLE the default.
+    enum class StepMode { BATCH, CYCLE };
+    void setStepMode(StepMode mode) { step_mode = mode; }
 
     // Interrupts
     bool irq_asserted = false;
 
+    // Level of the sample ring the SDL callback drains; the frontend can
+    // read it from any thread for latency control
+    RingBuffer<float>::Stats audioStats() const { return audio_buffer.stats(); }
+
+    // Output health, on the emulation thread: audio queued ahead of the
+    // speaker (ring plus one device block), the resampler's current ratio
+    // and the device callback's underruns
+    struct AudioStatus {
+        double latency_ms = 0.0;
+        double rate_ratio = 1.0;
+        uint64_t underruns = 0;
+    };
+    AudioStatus audioStatus() const;
+    void setAudioLatency(double ms) { resampler.setTarget(ms); } // Target the resampler steers to
+
+    // How the mixed output becomes samples at the device rate: its steps
+    // through the blip buffer (the default, cheapest), or its value every
+    // CPU cycle through the windowed-sinc decimator (cleanest spectrum,
+    // PolyphaseDecimator::taps() multiply-adds per sample)
+    enum class AudioFilter { BLEP, SINC };
+    void setAudioFilter(AudioFilter filter);
+
+    // Appends every sample at the device rate, before rate steering, to
+    // samples (nullptr stops). Works without an audio device.
+    void setAudioCapture(std::vector<float>* samples) { audio_capture = samples; }
+
 private:
+    void stepCycles(int cycles);
+    void stepBatch(int cycles);
+    int cyclesUntilFrameEvent() const;
     void stepFrameCounter();
-    void generateSample();
+
+    // --- Synthesis ---
+    // Each channel's output level is recorded with its CPU-cycle time in
+    // the audio frame whenever it changes: at the sequencer clocks of the
+    // timers, and after frame-counter steps and register writes. Once per
+    // audio frame the four streams are merged in time order, the levels at
+    // each change are mixed as one block and the mixed output goes through
+    // the selected AudioFilter.
+    struct LevelChange {
+        uint32_t time;
+        uint8_t level;
+    };
+
+    enum { PULSE1, PULSE2, TRIANGLE, NOISE, CHANNEL_COUNT };
+
+    template <typename Channel>
+    void runTimer(Channel& channel, int index, uint32_t steps, uint32_t first, uint32_t stride);
+    void recordLevel(int channel, uint32_t time, uint8_t level);
+    void updateLevels(); // All channels at frame_time
+    void endAudioFrame();
+
+    static void audioCallback(void* userdata, Uint8* stream, int len); // SDL audio thread
 
     // Channels
     PulseChannel pulse1;
@@ -157,21 +226,50 @@ private:
     TriangleChannel triangle;
     NoiseChannel noise;
 
+#ifdef APU_CYCLE_STEP
+    StepMode step_mode = StepMode::CYCLE;
+#else
+    StepMode step_mode = StepMode::BATCH;
+#endif
+
     // Frame Counter
     uint64_t frame_clock_counter = 0;
     uint8_t frame_mode = 0; // 0: 4-step, 1: 5-step
     bool irq_inhibit = false;
 
-    // SDL2 Audio
-    SDL_AudioDeviceID audio_device = 0;
-    double time_per_sample = 0.0;
-    double time_accumulator = 0.0;
-    
     // Constants
     static constexpr int AUDIO_SAMPLE_RATE = 44100;
     static constexpr double CPU_FREQUENCY = 1789773.0;
-
-    // Variables for mixing
-    uint8_t p1_out, p2_out, tri_out, noise_out, dmc_out;
-    float sample_out, pulse_out, tnd_out;
-};
\ No newline at end of file
+    static constexpr uint32_t AUDIO_FRAME_CYCLES = 29781; // One NTSC video frame
+    static constexpr std::size_t AUDIO_BUFFER_SAMPLES = 8192; // ~186ms at 44.1kHz
+    static constexpr double AUDIO_LATENCY_MS = 50.0;
+
+    // Level changes of the current audio frame
+    uint32_t frame_time = 0; // CPU cycles since the audio frame started
+    std::array<std::vector<LevelChange>, CHANNEL_COUNT> level_changes;
+    std::array<uint8_t, CHANNEL_COUNT> levels{};       // Latest recorded levels
+    std::array<uint8_t, CHANNEL_COUNT> frame_levels{}; // Levels at the frame start
+    float mixed_level = 0.0f; // Mixed output at the end of the last frame
+
+    // The frame's merged changes: each distinct time, the channel levels
+    // after it, and their mix
+    std::vector<uint32_t> mix_times;
+    std::array<std::vector<uint8_t>, CHANNEL_COUNT> mix_levels;
+    std::vector<float> mix_out;
+
+    BlipBuffer blip{CPU_FREQUENCY, AUDIO_SAMPLE_RATE, AUDIO_FRAME_CYCLES};
+    std::vector<float> frame_samples;
+    std::unique_ptr<PolyphaseDecimator> decimator; // AudioFilter::SINC only
+    std::vector<float> cycle_levels;                // Mixed output per cycle of the frame, for it
+    std::vector<float>* audio_capture = nullptr;
+    AdaptiveResampler resampler{AUDIO_SAMPLE_RATE, AUDIO_LATENCY_MS};
+    std::vector<float> output_samples;
+
+    // SDL2 Audio. endAudioFrame() pushes into audio_buffer, the SDL
+    // callback pulls whole device blocks out of it.
+    SDL_AudioDeviceID audio_device = 0;
+    int device_samples = 0; // Samples per device callback
+    bool audio_started = false; // Device unpaused, after the ring first filled
+    RingBuffer<float> audio_buffer{AUDIO_BUFFER_SAMPLES};
+    float last_output = 0.0f; // Callback thread only: held through underruns
+};
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+// =============================================================
+// BAND-LIMITED STEP BUFFER
+// -----------------
+// Turns a signal given as amplitude steps at clock timestamps into output
+// samples without aliasing. addDelta() places a windowed-sinc impulse of
+// the step's height at its exact sub-sample position (one of PHASES
+// pre-built kernels); reading integrates the impulses, which gives each
+// step a band-limited edge. Work is per step, not per clock, so a quiet
+// channel costs nothing and a square wave costs two kernels per period.
+//
+// Time is counted in clocks from the start of the current frame. A frame
+// is closed with endFrame(), which makes its samples readable; they must
+// be read before the next frame is closed.
+// =============================================================
+
+class BlipBuffer {
+    public:
+        static constexpr int WIDTH = 16;  // Kernel taps (8 samples each side)
+        static constexpr int PHASES = 128; // Sub-sample positions
+
+        // max_frame_clocks: longest frame that will be passed to endFrame()
+        BlipBuffer(double clock_rate, int sample_rate, uint32_t max_frame_clocks);
+
+        void setRates(double clock_rate, int sample_rate);
+        int sampleRate() const { return sample_rate; }
+
+        void addDelta(uint32_t time, float delta);
+        void endFrame(uint32_t clocks);
+
+        int samplesAvailable() const { return available; }
+        int readSamples(float* out, int count);
+        void clear();
+
+    private:
+        void resize();
+
+        double clock_rate;
+        int sample_rate;
+        uint32_t max_frame_clocks;
+
+        uint64_t factor = 0; // Samples per clock, 32.32 fixed point
+        uint64_t offset = 0; // Sub-sample position of the frame start, same format
+        int available = 0;   // Finished samples at the front of buffer
+        double integrator = 0.0;
+
+        std::vector<float> buffer; // Impulses, not yet integrated
+        std::array<std::array<float, WIDTH>, PHASES> kernels;
+};
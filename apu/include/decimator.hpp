@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "simd.hpp"
+
+// =============================================================
+// POLYPHASE DECIMATOR
+// -----------------
+// Windowed-sinc low-pass and rate conversion in one FIR, for streams far
+// above the output rate (the APU's per-cycle output at ~1.79MHz down to
+// 44.1/48kHz). Each output sample is one dot product of the input around
+// its exact time with the filter taps for that sub-sample phase; the
+// ratio may be any real number. The passband ends at 0.42 of the output
+// rate (18.5kHz at 44.1kHz); everything that would alias into it is
+// attenuated by ~74dB (Blackman window).
+//
+// Works on plain float blocks, so it serves the SDL output and offline
+// capture alike. Dot products use AVX2 or SSE2 kernels when the host has
+// them (selected once at runtime), a scalar loop otherwise.
+// =============================================================
+
+class PolyphaseDecimator {
+    public:
+        static constexpr int PHASES = 64; // Output times rounded to 1/64 input sample
+
+        PolyphaseDecimator(double input_rate, double output_rate);
+
+        // Appends the output samples count more input samples complete
+        void process(const float* in, std::size_t count, std::vector<float>& out);
+
+        // Forgets the input, as if it had been level forever
+        void reset(float level = 0.0f);
+
+        int taps() const { return tap_count; } // Per output sample, a multiple of 8
+
+    private:
+        double ratio; // Input samples per output sample
+        int tap_count;
+
+        std::vector<float> coefficients; // PHASES rows of tap_count
+        std::vector<float> history;      // Input not yet consumed
+        double position = 0.0;           // Time of the next output, in history samples
+};
+
+// The dot product of n floats (a multiple of 8) with one SimdLevel's
+// kernel, as process() computes each output sample
+float dotProduct(const float* x, const float* h, int n, SimdLevel level);
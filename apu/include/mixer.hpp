@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include "simd.hpp"
+
+// =============================================================
+// NES MIXER
+// -----------------
+// The non-linear DAC as two lookup tables indexed by summed channel
+// levels: pulse1 + pulse2 (0-30), and 3 * triangle + 2 * noise + dmc
+// (0-202), the usual linear fit of the triangle/noise/DMC formula. A
+// sample is two loads and an add.
+// =============================================================
+
+inline constexpr std::array<float, 31> pulse_table = [] {
+    std::array<float, 31> table{};
+    for (int n = 1; n < 31; ++n) table[n] = static_cast<float>(95.88 / (8128.0 / n + 100.0));
+    return table;
+}();
+
+inline constexpr std::array<float, 203> tnd_table = [] {
+    std::array<float, 203> table{};
+    for (int n = 1; n < 203; ++n) table[n] = static_cast<float>(163.67 / (24329.0 / n + 100.0));
+    return table;
+}();
+
+inline float mixLevels(uint8_t pulse1, uint8_t pulse2, uint8_t triangle, uint8_t noise, uint8_t dmc) {
+    return pulse_table[pulse1 + pulse2] + tnd_table[3 * triangle + 2 * noise + dmc];
+}
+
+// Mixes count sets of channel levels, one array per channel (dmc may be
+// nullptr for a silent DMC), into out. Uses AVX2 or SSE2 kernels when the
+// host has them; the result is the same as mixLevels() per element.
+void mixBlock(const uint8_t* pulse1, const uint8_t* pulse2, const uint8_t* triangle, const uint8_t* noise,
+              const uint8_t* dmc, std::size_t count, float* out);
+void mixBlock(const uint8_t* pulse1, const uint8_t* pulse2, const uint8_t* triangle, const uint8_t* noise,
+              const uint8_t* dmc, std::size_t count, float* out, SimdLevel level); // That level's kernel
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+// =============================================================
+// ADAPTIVE-RATE RESAMPLER
+// -----------------
+// Sits between the APU's samples and the output ring. The emulator is
+// paced by the frame limiter, the device by its own clock, so at a fixed
+// ratio the ring slowly drains (underruns) or fills (latency grows). Each
+// block nudges the ratio by at most max_adjust (0.5% by default, below
+// audible pitch change) from how far the queued samples are from the
+// target, which holds the queue near the target latency.
+// Samples are interpolated with a Catmull-Rom cubic.
+// =============================================================
+
+class AdaptiveResampler {
+    public:
+        AdaptiveResampler(int sample_rate, double target_ms, double max_adjust = 0.005);
+
+        void setSampleRate(int rate);
+        void setTarget(double ms);
+        double targetMs() const { return target_ms; }
+        double ratio() const { return rate_ratio; } // Output samples per input sample
+
+        // Appends count input samples, resampled, to out. queued: samples
+        // waiting downstream (ring and device) before these are added.
+        void process(const float* in, std::size_t count, std::size_t queued, std::vector<float>& out);
+        void reset();
+
+    private:
+        int sample_rate;
+        double target_ms;
+        double max_adjust;
+        double target_samples = 0.0;
+
+        double rate_ratio = 1.0;
+        double integral = 0.0;
+        double smoothed_queue = -1.0; // Negative until the first block
+
+        std::vector<float> history{0.0f}; // history[k] is input sample k - 1
+        double position = 0.0;            // Of the next output, in input samples
+};
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// =============================================================
+// SPSC RING BUFFER
+// -----------------
+// Lock-free queue between exactly one producer thread (the emulation
+// thread, which pushes each audio frame's samples from APU::endAudioFrame)
+// and one consumer thread (the SDL audio callback). Capacity is rounded up
+// to a power of two. head and tail only ever grow; each side owns one of
+// them and publishes it with a release store, so a push or pop is a few
+// loads and stores, never a lock.
+//
+// Both sides count their failures: samples dropped because the ring was
+// full (overruns) and pops that came up short (underruns). fill() is the
+// level at the moment of the call and only exact on the calling side.
+// =============================================================
+
+template <typename T>
+class RingBuffer {
+    public:
+        struct Stats {
+            std::size_t fill = 0;
+            std::size_t capacity = 0;
+            std::size_t peak_fill = 0; // Highest level seen by push()
+            std::uint64_t overruns = 0;
+            std::uint64_t underruns = 0;
+        };
+
+        explicit RingBuffer(std::size_t min_capacity) {
+            std::size_t capacity = 1;
+            while (capacity < min_capacity) capacity <<= 1;
+            data.resize(capacity);
+            mask = capacity - 1;
+        }
+
+        // Producer side. Returns how many of count items fit.
+        std::size_t push(const T* items, std::size_t count) {
+            const std::size_t tail = tail_index.load(std::memory_order_relaxed);
+            const std::size_t head = head_index.load(std::memory_order_acquire);
+            const std::size_t free = data.size() - (tail - head);
+            const std::size_t n = count < free ? count : free;
+            for (std::size_t i = 0; i < n; ++i) data[(tail + i) & mask] = items[i];
+            tail_index.store(tail + n, std::memory_order_release);
+
+            const std::size_t level = tail + n - head;
+            if (level > peak.load(std::memory_order_relaxed)) peak.store(level, std::memory_order_relaxed);
+            if (n < count) overruns.fetch_add(count - n, std::memory_order_relaxed);
+            return n;
+        }
+
+        bool push(const T& item) { return push(&item, 1) == 1; }
+
+        // Consumer side. Returns how many items were copied to out; fewer
+        // than count counts as an underrun.
+        std::size_t pop(T* out, std::size_t count) {
+            const std::size_t head = head_index.load(std::memory_order_relaxed);
+            const std::size_t tail = tail_index.load(std::memory_order_acquire);
+            const std::size_t available = tail - head;
+            const std::size_t n = count < available ? count : available;
+            for (std::size_t i = 0; i < n; ++i) out[i] = data[(head + i) & mask];
+            head_index.store(head + n, std::memory_order_release);
+
+            if (n < count) underruns.fetch_add(1, std::memory_order_relaxed);
+            return n;
+        }
+
+        std::size_t fill() const {
+            return tail_index.load(std::memory_order_acquire) - head_index.load(std::memory_order_acquire);
+        }
+        std::size_t capacity() const { return data.size(); }
+
+        Stats stats() const {
+            Stats s;
+            s.fill = fill();
+            s.capacity = data.size();
+            s.peak_fill = peak.load(std::memory_order_relaxed);
+            s.overruns = overruns.load(std::memory_order_relaxed);
+            s.underruns = underruns.load(std::memory_order_relaxed);
+            return s;
+        }
+
+    private:
+        std::vector<T> data;
+        std::size_t mask = 0;
+
+        // Producer and consumer indices on separate cache lines
+        alignas(64) std::atomic<std::size_t> head_index{0};
+        alignas(64) std::atomic<std::size_t> tail_index{0};
+        alignas(64) std::atomic<std::size_t> peak{0};
+        std::atomic<std::uint64_t> overruns{0};
+        alignas(64) std::atomic<std::uint64_t> underruns{0};
+};
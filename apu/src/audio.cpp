@@ -2,6 +2,7 @@
 #include <algorithm>
 #include <iostream>
 #include <cmath>
+#include <limits>
 
 // =============================================================
 // SHARED LOOKUP TABLES
@@ -14,6 +15,19 @@ const uint8_t PulseChannel::length_table[32] = {
     12, 16, 24, 18, 48, 20, 96, 22, 192, 24, 72, 26, 16, 28, 32, 30
 };
 
+// Closed form of `clocks` steps of a divider that counts `value` down and
+// reloads it with `period` on the step after it reached 0. Returns the
+// number of reloads, i.e. how often the channel's sequencer is clocked.
+static uint32_t advanceTimer(uint16_t& value, uint32_t period, uint32_t clocks) {
+    if (clocks <= value) {
+        value = static_cast<uint16_t>(value - clocks);
+        return 0;
+    }
+    clocks -= value + 1u;
+    value = static_cast<uint16_t>(period - clocks % (period + 1));
+    return 1 + clocks / (period + 1);
+}
+
 // =============================================================
 // PULSE CHANNEL IMPLEMENTATION
 // =============================================================
@@ -71,6 +85,11 @@ void PulseChannel::stepTimer() {
     }
 }
 
+void PulseChannel::stepTimer(uint32_t clocks) {
+    uint32_t reloads = advanceTimer(timer_value, (timer_period + 1) * 2, clocks);
+    duty_pos = static_cast<uint8_t>((duty_pos + reloads) & 0x07);
+}
+
 void PulseChannel::stepEnvelope() {
     if (env_start_flag) {
         env_start_flag = false;
@@ -106,6 +125,10 @@ uint8_t PulseChannel::getOutput() {
     return constant_volume ? vol_period : decay_level;
 }
 
+bool PulseChannel::sequencerAudible() const {
+    return enabled && length_counter > 0 && timer_period >= 8 && (constant_volume ? vol_period : decay_level) > 0;
+}
+
 // =============================================================
 // TRIANGLE CHANNEL IMPLEMENTATION
 // =============================================================
@@ -155,6 +178,13 @@ void TriangleChannel::stepTimer() {
     }
 }
 
+void TriangleChannel::stepTimer(uint32_t clocks) {
+    uint32_t reloads = advanceTimer(timer_value, timer_period, clocks);
+    if (length_counter > 0 && linear_counter > 0) {
+        seq_pos = static_cast<uint8_t>((seq_pos + reloads) & 0x1F);
+    }
+}
+
 void TriangleChannel::stepLength() {
     if (!lc_control_flag && length_counter > 0) {
         length_counter--;
@@ -181,6 +211,10 @@ uint8_t TriangleChannel::getOutput() {
     return sequence_table[seq_pos];
 }
 
+bool TriangleChannel::sequencerAudible() const {
+    return enabled && length_counter > 0 && linear_counter > 0;
+}
+
 // =============================================================
 // NOISE CHANNEL IMPLEMENTATION
 // =============================================================
@@ -231,6 +265,16 @@ void NoiseChannel::stepTimer() {
     }
 }
 
+void NoiseChannel::stepTimer(uint32_t clocks) {
+    uint32_t reloads = advanceTimer(timer_value, timer_period, clocks);
+    uint8_t feedback_bit_pos = mode_flag ? 6 : 1;
+    for (uint32_t i = 0; i < reloads; ++i) {
+        uint16_t feedback = (lfsr & 0x01) ^ ((lfsr >> feedback_bit_pos) & 0x01);
+        lfsr >>= 1;
+        lfsr |= (feedback << 14);
+    }
+}
+
 void NoiseChannel::stepEnvelope() {
     if (env_start_flag) {
         env_start_flag = false;
@@ -264,6 +308,10 @@ uint8_t NoiseChannel::getOutput() {
     return constant_volume ? vol_period : decay_level;
 }
 
+bool NoiseChannel::sequencerAudible() const {
+    return enabled && length_counter > 0 && (constant_volume ? vol_period : decay_level) > 0;
+}
+
 
 // =============================================================
 // APU IMPLEMENTATION
@@ -279,18 +327,24 @@ APU::APU() {
         want.format = AUDIO_F32;
         want.channels = 1;
         want.samples = 1024;
+        want.callback = &APU::audioCallback;
+        want.userdata = this;
         
-        audio_device = SDL_OpenAudioDevice(NULL, 0, &want, &have, 0);
+        // 44.1kHz, or whatever the device prefers: the blip buffer
+        // synthesizes at any rate
+        audio_device = SDL_OpenAudioDevice(NULL, 0, &want, &have, SDL_AUDIO_ALLOW_FREQUENCY_CHANGE);
         
         if (audio_device == 0) {
             std::cerr << "APU: Failed to open audio device: " << SDL_GetError() << std::endl;
         } else {
-            SDL_PauseAudioDevice(audio_device, 0);
+            blip.setRates(CPU_FREQUENCY, have.freq);
+            resampler.setSampleRate(have.freq);
+            device_samples = have.samples;
+            // Unpaused by endAudioFrame() once the ring holds the target
             std::cout << "APU: Audio initialized at " << have.freq << "Hz" << std::endl;
         }
     }
 
-    time_per_sample = CPU_FREQUENCY / AUDIO_SAMPLE_RATE;
     reset();
 }
 
@@ -304,7 +358,6 @@ void APU::reset() {
     cpuWrite(0x4015, 0x00);
     cpuWrite(0x4017, 0x00);
     irq_asserted = false;
-    time_accumulator = 0;
 }
 
 void APU::cpuWrite(uint16_t addr, uint8_t data) {
@@ -357,6 +410,8 @@ void APU::cpuWrite(uint16_t addr, uint8_t data) {
             }
             break;
     }
+
+    updateLevels(); // Volume, duty, length and enable writes are heard at once
 }
 
 uint8_t APU::cpuRead(uint16_t addr) {
@@ -375,7 +430,24 @@ uint8_t APU::cpuRead(uint16_t addr) {
     return 0;
 }
 
+// Audio frames end every AUDIO_FRAME_CYCLES cycles wherever the calls
+// fall, so the samples do not depend on how the APU is synced
 void APU::step(int cycles) {
+    while (cycles > 0) {
+        int span = std::min(cycles, static_cast<int>(AUDIO_FRAME_CYCLES - frame_time));
+        if (step_mode == StepMode::CYCLE) {
+            stepCycles(span);
+        } else {
+            stepBatch(span);
+        }
+        if (frame_time == AUDIO_FRAME_CYCLES) endAudioFrame();
+        cycles -= span;
+    }
+}
+
+// Reference path: every unit clocked once per CPU cycle, every output
+// checked after each cycle
+void APU::stepCycles(int cycles) {
     for (int i = 0; i < cycles; ++i) {
         // Clock timers
         if (frame_clock_counter % 2 == 0) {
@@ -390,15 +462,76 @@ void APU::step(int cycles) {
         frame_clock_counter++;
         stepFrameCounter();
 
-        // Audio Sampling
-        time_accumulator++;
-        if (time_accumulator >= time_per_sample) {
-            time_accumulator -= time_per_sample;
-            generateSample();
-        }
+        frame_time++;
+        updateLevels();
     }
 }
 
+// Batch path. Between frame-sequencer steps nothing but the channel
+// timers changes, so each span up to the next step advances the timers
+// in closed form, stopping only at the sequencer clocks of channels that
+// can be heard, and then runs the step on its last cycle. The levels
+// recorded are the ones stepCycles() records.
+void APU::stepBatch(int cycles) {
+    while (cycles > 0) {
+        int span = std::min(cycles, cyclesUntilFrameEvent());
+
+        // Pulse and noise timers tick on even frame counter values: in the
+        // span's first or second cycle, then every other one
+        uint32_t even_clocks = static_cast<uint32_t>((frame_clock_counter + span + 1) / 2 - (frame_clock_counter + 1) / 2);
+        uint32_t first_even = 1 + static_cast<uint32_t>(frame_clock_counter & 1);
+        runTimer(pulse1, PULSE1, even_clocks, first_even, 2);
+        runTimer(pulse2, PULSE2, even_clocks, first_even, 2);
+        runTimer(noise, NOISE, even_clocks, first_even, 2);
+        runTimer(triangle, TRIANGLE, static_cast<uint32_t>(span), 1, 1);
+
+        frame_clock_counter += span;
+        frame_time += span;
+        stepFrameCounter(); // No-op unless the span ended on a sequencer step
+        updateLevels();
+
+        cycles -= span;
+    }
+}
+
+// Runs steps timer clocks of a channel, the n-th (from 1) in cycle
+// first + (n - 1) * stride of the span, recording the output after each
+// sequencer clock
+template <typename Channel>
+void APU::runTimer(Channel& channel, int index, uint32_t steps, uint32_t first, uint32_t stride) {
+    if (!channel.sequencerAudible()) {
+        channel.stepTimer(steps);
+        return;
+    }
+    uint32_t done = 0;
+    while (steps - done > channel.timer_value) {
+        uint32_t to_clock = channel.timer_value + 1u;
+        channel.stepTimer(to_clock);
+        done += to_clock;
+        recordLevel(index, frame_time + first + (done - 1) * stride, channel.getOutput());
+    }
+    channel.stepTimer(steps - done);
+}
+
+// Cycles until the frame counter reaches its next sequencer step (the
+// value stepFrameCounter() acts on), counting the cycle that reaches it
+int APU::cyclesUntilFrameEvent() const {
+    static constexpr uint64_t steps[2][5] = {
+        {7457, 14915, 22372, 29829, 29830},
+        {7457, 14915, 22372, 37281, 37282}
+    };
+    for (uint64_t at : steps[frame_mode]) {
+        if (frame_clock_counter < at) return static_cast<int>(at - frame_clock_counter);
+    }
+    return 1;
+}
+
+int APU::cyclesUntilFrameIRQ() const {
+    if (frame_mode != 0 || irq_inhibit) return std::numeric_limits<int>::max();
+    if (frame_clock_counter < 29829) return static_cast<int>(29829 - frame_clock_counter);
+    return static_cast<int>(29830 - frame_clock_counter);
+}
+
 void APU::stepFrameCounter() {
     // Mode 0: 4-step sequence
     // Mode 1: 5-step sequence
@@ -435,30 +568,133 @@ void APU::stepFrameCounter() {
     }
 }
 
-void APU::generateSample() {
+// =============================================================
+// SYNTHESIS
+// =============================================================
+
+void APU::recordLevel(int channel, uint32_t time, uint8_t level) {
+    if (level == levels[channel]) return;
+    levels[channel] = level;
+
+    // Changes within one cycle collapse into the last one
+    std::vector<LevelChange>& changes = level_changes[channel];
+    if (!changes.empty() && changes.back().time == time) {
+        changes.back().level = level;
+    } else {
+        changes.push_back(LevelChange{time, level});
+    }
+}
+
+void APU::updateLevels() {
+    recordLevel(PULSE1, frame_time, pulse1.getOutput());
+    recordLevel(PULSE2, frame_time, pulse2.getOutput());
+    recordLevel(TRIANGLE, frame_time, triangle.getOutput());
+    recordLevel(NOISE, frame_time, noise.getOutput());
+}
+
+// Merges the channels' changes in time order, mixes the levels at every
+// distinct time in one block and turns the mix into samples with the
+// selected filter
+void APU::endAudioFrame() {
+    mix_times.clear();
+    for (auto& channel_levels : mix_levels) channel_levels.clear();
+
+    std::array<std::size_t, CHANNEL_COUNT> next{};
+    std::array<uint8_t, CHANNEL_COUNT> current = frame_levels;
+    while (true) {
+        uint32_t time = std::numeric_limits<uint32_t>::max();
+        for (int ch = 0; ch < CHANNEL_COUNT; ++ch) {
+            if (next[ch] < level_changes[ch].size()) time = std::min(time, level_changes[ch][next[ch]].time);
+        }
+        if (time == std::numeric_limits<uint32_t>::max()) break;
+
+        for (int ch = 0; ch < CHANNEL_COUNT; ++ch) {
+            if (next[ch] < level_changes[ch].size() && level_changes[ch][next[ch]].time == time) {
+                current[ch] = level_changes[ch][next[ch]++].level;
+            }
+            mix_levels[ch].push_back(current[ch]);
+        }
+        mix_times.push_back(time);
+    }
+
+    mix_out.resize(mix_times.size());
+    mixBlock(mix_levels[PULSE1].data(), mix_levels[PULSE2].data(), mix_levels[TRIANGLE].data(),
+             mix_levels[NOISE].data(), nullptr, mix_times.size(), mix_out.data());
+
+    frame_samples.clear();
+    if (decimator) {
+        // The level after a change at time t holds from cycle t on
+        cycle_levels.resize(frame_time);
+        uint32_t from = 0;
+        for (std::size_t i = 0; i < mix_times.size(); ++i) {
+            const uint32_t to = std::min(mix_times[i], frame_time);
+            std::fill(cycle_levels.begin() + from, cycle_levels.begin() + to, mixed_level);
+            from = to;
+            mixed_level = mix_out[i];
+        }
+        std::fill(cycle_levels.begin() + from, cycle_levels.end(), mixed_level);
+        decimator->process(cycle_levels.data(), cycle_levels.size(), frame_samples);
+    } else {
+        for (std::size_t i = 0; i < mix_times.size(); ++i) {
+            if (mix_out[i] != mixed_level) {
+                blip.addDelta(mix_times[i], mix_out[i] - mixed_level);
+                mixed_level = mix_out[i];
+            }
+        }
+        blip.endFrame(frame_time);
+        frame_samples.resize(static_cast<std::size_t>(blip.samplesAvailable()));
+        blip.readSamples(frame_samples.data(), static_cast<int>(frame_samples.size()));
+    }
+    for (auto& changes : level_changes) changes.clear();
+    frame_levels = levels;
+    frame_time = 0;
+
+    if (audio_capture) audio_capture->insert(audio_capture->end(), frame_samples.begin(), frame_samples.end());
     if (audio_device == 0) return;
 
-    p1_out = pulse1.getOutput();
-    p2_out = pulse2.getOutput();
-    tri_out = triangle.getOutput();
-    noise_out = noise.getOutput();
-    dmc_out = 0; // Not implemented yet
-    
-    // --- MIXER ---
-    // Pulse Mix
-    pulse_out = 0.0f;
-    if (p1_out > 0 || p2_out > 0) {
-        pulse_out = 95.88f / ((8128.0f / (p1_out + p2_out)) + 100.0f);
+    // Resampled to steer the queue towards the target latency; dropped,
+    // and counted, if the ring is full all the same
+    const std::size_t queued = audio_buffer.fill() + static_cast<std::size_t>(device_samples);
+    output_samples.clear();
+    resampler.process(frame_samples.data(), frame_samples.size(), queued, output_samples);
+    audio_buffer.push(output_samples.data(), output_samples.size());
+
+    if (!audio_started && audio_buffer.fill() * 1000.0 >= resampler.targetMs() * blip.sampleRate()) {
+        SDL_PauseAudioDevice(audio_device, 0);
+        audio_started = true;
     }
-    
-    // TND (Triangle, Noise, DMC) Mix
-    // Formula: 159.79 / (1 / (triangle / 8227 + noise / 12241 + dmc / 22638) + 100)
-    tnd_out = 0.0f;
-    if (tri_out > 0 || noise_out > 0 || dmc_out > 0) {
-        tnd_out = 159.79f / ((1.0f / ((tri_out / 8227.0f) + (noise_out / 12241.0f) + (dmc_out / 22638.0f))) + 100.0f);
+}
+
+// Either filter starts from the current mixed level, so switching
+// between them is a short transient rather than a jump
+void APU::setAudioFilter(AudioFilter filter) {
+    if (filter == AudioFilter::SINC) {
+        decimator = std::make_unique<PolyphaseDecimator>(CPU_FREQUENCY, blip.sampleRate());
+        decimator->reset(mixed_level);
+    } else if (decimator) {
+        decimator.reset();
+        blip.clear();
+        blip.addDelta(0, mixed_level);
     }
-    
-    sample_out = pulse_out + tnd_out;
-    
-    SDL_QueueAudio(audio_device, &sample_out, sizeof(float));
+}
+
+APU::AudioStatus APU::audioStatus() const {
+    AudioStatus status;
+    const RingBuffer<float>::Stats ring = audio_buffer.stats();
+    status.latency_ms = 1000.0 * static_cast<double>(ring.fill + device_samples) / blip.sampleRate();
+    status.rate_ratio = resampler.ratio();
+    status.underruns = ring.underruns;
+    return status;
+}
+
+// Fills a device block from the ring. On an underrun the rest of the block
+// holds the last sample played rather than dropping to 0, which would click.
+void APU::audioCallback(void* userdata, Uint8* stream, int len) {
+    APU* apu = static_cast<APU*>(userdata);
+    float* out = reinterpret_cast<float*>(stream);
+    const std::size_t count = static_cast<std::size_t>(len) / sizeof(float);
+
+    const std::size_t got = apu->audio_buffer.pop(out, count);
+    if (got > 0) apu->last_output = out[got - 1];
+    std::fill(out + got, out + count, apu->last_output);
 }
\ No newline at end of file
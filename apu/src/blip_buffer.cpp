@@ -0,0 +1,88 @@
+#include "blip_buffer.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+constexpr double PI = 3.14159265358979323846;
+constexpr double CUTOFF = 0.42; // Passband edge, fraction of the output rate
+
+// Sinc low-pass impulse, Blackman window over the kernel width
+double impulse(double x) {
+    const double w = 2.0 * PI * x / BlipBuffer::WIDTH;
+    const double window = 0.42 + 0.5 * std::cos(w) + 0.08 * std::cos(2.0 * w);
+    const double arg = 2.0 * PI * CUTOFF * x;
+    const double sinc = x == 0.0 ? 1.0 : std::sin(arg) / arg;
+    return 2.0 * CUTOFF * sinc * window;
+}
+
+} // namespace
+
+BlipBuffer::BlipBuffer(double clock, int rate, uint32_t max_clocks)
+    : clock_rate(clock), sample_rate(rate), max_frame_clocks(max_clocks) {
+    // Tap k of phase p sits at k + 1/2 - WIDTH/2 - p/PHASES samples from
+    // the step: the half sample centres the impulse on the step once it is
+    // integrated. Each row sums to 1 so every step reaches its full height.
+    for (int phase = 0; phase < PHASES; ++phase) {
+        double sum = 0.0;
+        std::array<double, WIDTH> taps;
+        for (int k = 0; k < WIDTH; ++k) {
+            taps[k] = impulse(k + 0.5 - WIDTH / 2 - static_cast<double>(phase) / PHASES);
+            sum += taps[k];
+        }
+        for (int k = 0; k < WIDTH; ++k) kernels[phase][k] = static_cast<float>(taps[k] / sum);
+    }
+    setRates(clock, rate);
+}
+
+void BlipBuffer::setRates(double clock, int rate) {
+    clock_rate = clock;
+    sample_rate = rate;
+    factor = static_cast<uint64_t>(std::llround(sample_rate / clock_rate * 4294967296.0));
+    resize();
+}
+
+void BlipBuffer::resize() {
+    // A frame's samples plus the kernel tail hanging past them
+    const std::size_t frame_samples = static_cast<std::size_t>(((offset + max_frame_clocks * factor) >> 32) + 1);
+    const std::size_t size = static_cast<std::size_t>(available) + frame_samples + WIDTH;
+    if (buffer.size() < size) buffer.resize(size, 0.0f);
+}
+
+void BlipBuffer::clear() {
+    std::fill(buffer.begin(), buffer.end(), 0.0f);
+    offset = 0;
+    available = 0;
+    integrator = 0.0;
+}
+
+void BlipBuffer::addDelta(uint32_t time, float delta) {
+    const uint64_t position = offset + time * factor;
+    const auto phase = static_cast<int>((position >> (32 - 7)) & (PHASES - 1));
+    static_assert(PHASES == 1 << 7, "phase bits");
+
+    float* out = &buffer[available + static_cast<std::size_t>(position >> 32)];
+    const std::array<float, WIDTH>& kernel = kernels[phase];
+    for (int k = 0; k < WIDTH; ++k) out[k] += kernel[k] * delta;
+}
+
+void BlipBuffer::endFrame(uint32_t clocks) {
+    offset += clocks * factor;
+    available += static_cast<int>(offset >> 32);
+    offset &= 0xFFFFFFFFull;
+    resize();
+}
+
+int BlipBuffer::readSamples(float* out, int count) {
+    count = std::min(count, available);
+    for (int i = 0; i < count; ++i) {
+        integrator += buffer[i];
+        out[i] = static_cast<float>(integrator);
+    }
+
+    // Move the unread samples and the pending kernel tails to the front
+    std::copy(buffer.begin() + count, buffer.end(), buffer.begin());
+    std::fill(buffer.end() - count, buffer.end(), 0.0f);
+    available -= count;
+    return count;
+}
@@ -0,0 +1,144 @@
+#include "decimator.hpp"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define DECIMATOR_SIMD 1
+#include <immintrin.h>
+#endif
+
+static constexpr double PI = 3.14159265358979323846;
+static constexpr double PASSBAND = 0.42; // Passband edge, fraction of the output rate
+static constexpr double STOPBAND = 0.58; // Aliases onto the passband edge from here
+static constexpr double BLACKMAN_WIDTH = 5.5; // Transition width * taps, in input rate units
+
+// =============================================================
+// DOT PRODUCT KERNELS
+// -----------------
+// n is a multiple of 8. The vector kernels keep several partial sums, so
+// they round differently from the scalar loop (by far less than the
+// filter's stopband).
+// =============================================================
+
+using DotKernel = float (*)(const float* x, const float* h, int n);
+
+static float dotScalar(const float* x, const float* h, int n) {
+    float sum = 0.0f;
+    for (int i = 0; i < n; ++i) sum += x[i] * h[i];
+    return sum;
+}
+
+#ifdef DECIMATOR_SIMD
+
+static float dotSSE2(const float* x, const float* h, int n) {
+    __m128 a = _mm_setzero_ps();
+    __m128 b = _mm_setzero_ps();
+    for (int i = 0; i < n; i += 8) {
+        a = _mm_add_ps(a, _mm_mul_ps(_mm_loadu_ps(x + i), _mm_loadu_ps(h + i)));
+        b = _mm_add_ps(b, _mm_mul_ps(_mm_loadu_ps(x + i + 4), _mm_loadu_ps(h + i + 4)));
+    }
+    a = _mm_add_ps(a, b);
+    a = _mm_add_ps(a, _mm_movehl_ps(a, a));
+    a = _mm_add_ss(a, _mm_shuffle_ps(a, a, 1));
+    return _mm_cvtss_f32(a);
+}
+
+// Two accumulators hide the FMA latency; the tap count is not always a
+// multiple of 16, so the last 8 go to the first one
+__attribute__((target("avx2,fma")))
+static float dotAVX2(const float* x, const float* h, int n) {
+    __m256 a = _mm256_setzero_ps();
+    __m256 b = _mm256_setzero_ps();
+    int i = 0;
+    for (; i + 16 <= n; i += 16) {
+        a = _mm256_fmadd_ps(_mm256_loadu_ps(x + i), _mm256_loadu_ps(h + i), a);
+        b = _mm256_fmadd_ps(_mm256_loadu_ps(x + i + 8), _mm256_loadu_ps(h + i + 8), b);
+    }
+    if (i < n) a = _mm256_fmadd_ps(_mm256_loadu_ps(x + i), _mm256_loadu_ps(h + i), a);
+    a = _mm256_add_ps(a, b);
+    __m128 s = _mm_add_ps(_mm256_castps256_ps128(a), _mm256_extractf128_ps(a, 1));
+    s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+    s = _mm_add_ss(s, _mm_shuffle_ps(s, s, 1));
+    return _mm_cvtss_f32(s);
+}
+
+#endif
+
+static DotKernel selectKernel() {
+#ifdef DECIMATOR_SIMD
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) return dotAVX2;
+    return dotSSE2; // Part of x86-64
+#else
+    return dotScalar;
+#endif
+}
+
+float dotProduct(const float* x, const float* h, int n, SimdLevel level) {
+#ifdef DECIMATOR_SIMD
+    if (level == SimdLevel::AVX2) return dotAVX2(x, h, n);
+    if (level == SimdLevel::SSE2) return dotSSE2(x, h, n);
+#endif
+    (void)level;
+    return dotScalar(x, h, n);
+}
+
+// =============================================================
+// DECIMATOR
+// =============================================================
+
+PolyphaseDecimator::PolyphaseDecimator(double input_rate, double output_rate) : ratio(input_rate / output_rate) {
+    // Blackman transition is BLACKMAN_WIDTH / taps of the input rate wide
+    const double transition = (STOPBAND - PASSBAND) / ratio;
+    tap_count = std::max(8, static_cast<int>(std::ceil(BLACKMAN_WIDTH / transition / 8.0)) * 8);
+    const double cutoff = (PASSBAND + STOPBAND) / 2.0 / ratio; // Cycles per input sample
+    const int half = tap_count / 2;
+
+    // Tap k of phase p weighs the input k + 1 - half samples after the
+    // one at or before the output time, which lies p / PHASES later
+    coefficients.resize(static_cast<std::size_t>(PHASES) * tap_count);
+    for (int phase = 0; phase < PHASES; ++phase) {
+        float* row = &coefficients[static_cast<std::size_t>(phase) * tap_count];
+        double sum = 0.0;
+        std::vector<double> taps(tap_count);
+        for (int k = 0; k < tap_count; ++k) {
+            const double x = static_cast<double>(phase) / PHASES + half - 1 - k;
+            const double w = 2.0 * PI * x / tap_count;
+            const double window = 0.42 + 0.5 * std::cos(w) + 0.08 * std::cos(2.0 * w);
+            const double arg = 2.0 * PI * cutoff * x;
+            taps[k] = (x == 0.0 ? 1.0 : std::sin(arg) / arg) * window;
+            sum += taps[k];
+        }
+        for (int k = 0; k < tap_count; ++k) row[k] = static_cast<float>(taps[k] / sum); // Unity gain at DC
+    }
+    reset();
+}
+
+void PolyphaseDecimator::reset(float level) {
+    history.assign(static_cast<std::size_t>(tap_count), level);
+    position = tap_count / 2 - 1;
+}
+
+void PolyphaseDecimator::process(const float* in, std::size_t count, std::vector<float>& out) {
+    static const DotKernel kernel = selectKernel();
+    const std::size_t half = static_cast<std::size_t>(tap_count / 2);
+
+    history.insert(history.end(), in, in + count);
+    while (true) {
+        auto index = static_cast<std::size_t>(position);
+        auto phase = static_cast<int>(std::lround((position - index) * PHASES));
+        if (phase == PHASES) {
+            ++index;
+            phase = 0;
+        }
+        if (index + half >= history.size()) break;
+
+        out.push_back(kernel(&history[index + 1 - half], &coefficients[static_cast<std::size_t>(phase) * tap_count], tap_count));
+        position += ratio;
+    }
+
+    // Drop the input no later output reaches
+    const auto index = static_cast<std::size_t>(position);
+    const std::size_t used = index + 1 > half ? index + 1 - half : 0;
+    history.erase(history.begin(), history.begin() + static_cast<std::ptrdiff_t>(used));
+    position -= static_cast<double>(used);
+}
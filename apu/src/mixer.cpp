@@ -0,0 +1,122 @@
+#include "mixer.hpp"
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define MIXER_SIMD 1
+#include <immintrin.h>
+#endif
+
+// Zero levels for a missing DMC array
+static const uint8_t silence[64] = {};
+
+// =============================================================
+// BLOCK KERNELS
+// -----------------
+// Each mixes count elements. Table indices are formed with vector
+// arithmetic; SSE2 looks the entries up one at a time, AVX2 gathers eight.
+// Same results as mixLevels().
+// =============================================================
+
+using MixKernel = void (*)(const uint8_t* p1, const uint8_t* p2, const uint8_t* t, const uint8_t* n, const uint8_t* d,
+                           std::size_t count, float* out);
+
+static void mixScalar(const uint8_t* p1, const uint8_t* p2, const uint8_t* t, const uint8_t* n, const uint8_t* d,
+                      std::size_t count, float* out) {
+    for (std::size_t i = 0; i < count; ++i) out[i] = mixLevels(p1[i], p2[i], t[i], n[i], d[i]);
+}
+
+#ifdef MIXER_SIMD
+
+// Eight levels widened to 16 bits
+static inline __m128i load8x16(const uint8_t* src) {
+    return _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(src)), _mm_setzero_si128());
+}
+
+static void mixSSE2(const uint8_t* p1, const uint8_t* p2, const uint8_t* t, const uint8_t* n, const uint8_t* d,
+                    std::size_t count, float* out) {
+    std::size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m128i tri = load8x16(t + i);
+        const __m128i noise = load8x16(n + i);
+        const __m128i pulse = _mm_add_epi16(load8x16(p1 + i), load8x16(p2 + i));
+        const __m128i tnd = _mm_add_epi16(_mm_add_epi16(_mm_add_epi16(tri, tri), tri),
+                                          _mm_add_epi16(_mm_add_epi16(noise, noise), load8x16(d + i)));
+
+        alignas(16) uint16_t pulse_index[8];
+        alignas(16) uint16_t tnd_index[8];
+        _mm_store_si128(reinterpret_cast<__m128i*>(pulse_index), pulse);
+        _mm_store_si128(reinterpret_cast<__m128i*>(tnd_index), tnd);
+        for (int k = 0; k < 8; k += 4) {
+            const __m128 a = _mm_setr_ps(pulse_table[pulse_index[k]], pulse_table[pulse_index[k + 1]],
+                                         pulse_table[pulse_index[k + 2]], pulse_table[pulse_index[k + 3]]);
+            const __m128 b = _mm_setr_ps(tnd_table[tnd_index[k]], tnd_table[tnd_index[k + 1]],
+                                         tnd_table[tnd_index[k + 2]], tnd_table[tnd_index[k + 3]]);
+            _mm_storeu_ps(out + i + k, _mm_add_ps(a, b));
+        }
+    }
+    mixScalar(p1 + i, p2 + i, t + i, n + i, d + i, count - i, out + i);
+}
+
+// Eight levels widened to 32 bits
+__attribute__((target("avx2")))
+static inline __m256i load8x32(const uint8_t* src) {
+    return _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(src)));
+}
+
+__attribute__((target("avx2")))
+static void mixAVX2(const uint8_t* p1, const uint8_t* p2, const uint8_t* t, const uint8_t* n, const uint8_t* d,
+                    std::size_t count, float* out) {
+    std::size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m256i pulse = _mm256_add_epi32(load8x32(p1 + i), load8x32(p2 + i));
+        const __m256i tnd = _mm256_add_epi32(_mm256_mullo_epi32(load8x32(t + i), _mm256_set1_epi32(3)),
+                                             _mm256_add_epi32(_mm256_slli_epi32(load8x32(n + i), 1), load8x32(d + i)));
+        const __m256 a = _mm256_i32gather_ps(pulse_table.data(), pulse, 4);
+        const __m256 b = _mm256_i32gather_ps(tnd_table.data(), tnd, 4);
+        _mm256_storeu_ps(out + i, _mm256_add_ps(a, b));
+    }
+    mixScalar(p1 + i, p2 + i, t + i, n + i, d + i, count - i, out + i);
+}
+
+#endif
+
+static MixKernel selectKernel() {
+#ifdef MIXER_SIMD
+    if (__builtin_cpu_supports("avx2")) return mixAVX2;
+    return mixSSE2; // Part of x86-64
+#else
+    return mixScalar;
+#endif
+}
+
+static MixKernel levelKernel(SimdLevel level) {
+#ifdef MIXER_SIMD
+    if (level == SimdLevel::AVX2) return mixAVX2;
+    if (level == SimdLevel::SSE2) return mixSSE2;
+#endif
+    (void)level;
+    return mixScalar;
+}
+
+static void mixBlockWith(MixKernel kernel, const uint8_t* pulse1, const uint8_t* pulse2, const uint8_t* triangle,
+                         const uint8_t* noise, const uint8_t* dmc, std::size_t count, float* out) {
+    if (dmc) {
+        kernel(pulse1, pulse2, triangle, noise, dmc, count, out);
+        return;
+    }
+    // In chunks the size of the silent DMC array
+    for (std::size_t i = 0; i < count; i += sizeof(silence)) {
+        const std::size_t chunk = count - i < sizeof(silence) ? count - i : sizeof(silence);
+        kernel(pulse1 + i, pulse2 + i, triangle + i, noise + i, silence, chunk, out + i);
+    }
+}
+
+void mixBlock(const uint8_t* pulse1, const uint8_t* pulse2, const uint8_t* triangle, const uint8_t* noise,
+              const uint8_t* dmc, std::size_t count, float* out) {
+    static const MixKernel kernel = selectKernel();
+    mixBlockWith(kernel, pulse1, pulse2, triangle, noise, dmc, count, out);
+}
+
+void mixBlock(const uint8_t* pulse1, const uint8_t* pulse2, const uint8_t* triangle, const uint8_t* noise,
+              const uint8_t* dmc, std::size_t count, float* out, SimdLevel level) {
+    mixBlockWith(levelKernel(level), pulse1, pulse2, triangle, noise, dmc, count, out);
+}
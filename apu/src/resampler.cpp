@@ -0,0 +1,67 @@
+#include "resampler.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+constexpr double QUEUE_SMOOTHING = 0.05; // Per block; the device drains in bursts
+constexpr double PROPORTIONAL_GAIN = 5.0; // In units of max_adjust
+constexpr double INTEGRAL_GAIN = 0.01;    // Per block, same units
+
+float cubic(float y0, float y1, float y2, float y3, float t) {
+    const float a = -0.5f * y0 + 1.5f * y1 - 1.5f * y2 + 0.5f * y3;
+    const float b = y0 - 2.5f * y1 + 2.0f * y2 - 0.5f * y3;
+    const float c = -0.5f * y0 + 0.5f * y2;
+    return ((a * t + b) * t + c) * t + y1;
+}
+
+} // namespace
+
+AdaptiveResampler::AdaptiveResampler(int rate, double ms, double adjust)
+    : sample_rate(rate), target_ms(ms), max_adjust(adjust) {
+    setTarget(ms);
+}
+
+void AdaptiveResampler::setSampleRate(int rate) {
+    sample_rate = rate;
+    setTarget(target_ms);
+}
+
+void AdaptiveResampler::setTarget(double ms) {
+    target_ms = ms;
+    target_samples = std::max(1.0, ms * sample_rate / 1000.0);
+}
+
+void AdaptiveResampler::reset() {
+    rate_ratio = 1.0;
+    integral = 0.0;
+    smoothed_queue = -1.0;
+    history.assign(1, 0.0f);
+    position = 0.0;
+}
+
+void AdaptiveResampler::process(const float* in, std::size_t count, std::size_t queued, std::vector<float>& out) {
+    // PI control on the smoothed queue: too little queued means more
+    // output per input, too much means less. The proportional part reaches
+    // the full adjustment 20% off target; the integral takes out the
+    // steady offset from the frame limiter's drift, clamped to max_adjust.
+    const double level = static_cast<double>(queued);
+    smoothed_queue = smoothed_queue < 0.0 ? level : smoothed_queue + QUEUE_SMOOTHING * (level - smoothed_queue);
+    const double error = (target_samples - smoothed_queue) / target_samples;
+    integral = std::clamp(integral + INTEGRAL_GAIN * max_adjust * error, -max_adjust, max_adjust);
+    rate_ratio = 1.0 + std::clamp(PROPORTIONAL_GAIN * max_adjust * error + integral, -max_adjust, max_adjust);
+
+    history.insert(history.end(), in, in + count);
+    const double step = 1.0 / rate_ratio;
+    while (static_cast<std::size_t>(position) + 3 < history.size()) {
+        const auto i = static_cast<std::size_t>(position);
+        const auto t = static_cast<float>(position - i);
+        out.push_back(cubic(history[i], history[i + 1], history[i + 2], history[i + 3], t));
+        position += step;
+    }
+
+    // Keep the samples the next output still needs
+    const auto used = static_cast<std::size_t>(position);
+    history.erase(history.begin(), history.begin() + static_cast<std::ptrdiff_t>(used));
+    position -= static_cast<double>(used);
+}
@@ -9,6 +9,9 @@
 #include "audio.hpp"
 #include "cartridge.hpp"
 
+class Scheduler;
+class DeferredRenderer;
+
 class Bus {
     public:
         Bus();
@@ -28,15 +31,67 @@ class Bus {
         bool testMode = false;
         std::vector<uint8_t> testRam;
 
-        // CPU Bus Interface
-        void write(uint16_t address, uint8_t data);
-        uint8_t read(uint16_t address);
+        // CPU Bus Interface. Pages with a direct pointer (RAM, PRG-RAM,
+        // mapped PRG ROM) are served inline; the rest go to the handlers.
+        void write(uint16_t address, uint8_t data) {
+            if (uint8_t* page = writePages[address >> 8]) {
+                page[address & 0xFF] = data;
+                return;
+            }
+            writeIO(address, data);
+        }
+        uint8_t read(uint16_t address) {
+            if (const uint8_t* page = readPages[address >> 8]) return page[address & 0xFF];
+            return readIO(address);
+        }
         
+        // Deferred devices: with a scheduler attached the PPU and APU lag
+        // behind the CPU and are caught up before accesses that reach them
+        void attachScheduler(Scheduler* s) { scheduler = s; }
+        void syncPPU();
+        void syncAPU();
+
+        // Skip composing frames nobody will look at (see PPU::setFrameSkip).
+        // Catches the PPU up first so the switch lands at the current dot.
+        void setFrameSkip(bool skip);
+
+        // Draw frames on a deferred renderer's worker threads (see
+        // deferred.hpp), nullptr to draw on this thread again. Catches the
+        // PPU up first; call between frames.
+        void setDeferredRenderer(DeferredRenderer* renderer);
+
         // Utilities
         void setTestMode(bool enabled);
         bool getIRQ() const; 
+        int cpuCyclesUntilInterrupt(bool irq_masked) const;
         void reset();
 
+        // Direct view of the 2KB internal RAM (for the JIT)
+        uint8_t* getRam() { return cpuRam.data(); }
+
     private:
         std::array<uint8_t, 2048> cpuRam;
+        Scheduler* scheduler = nullptr;
+
+        // =============================================================
+        // CPU PAGE TABLE
+        // -----------------
+        // One host pointer per 256-byte page of the CPU address space, or
+        // nullptr where the access needs a handler: $2000-$40FF (PPU, APU,
+        // controllers) and anything the mapper does not back with plain
+        // memory, including every PRG ROM write. Rebuilt when the
+        // cartridge's PRG mapping version changes.
+        // =============================================================
+        std::array<const uint8_t*, 256> readPages{};
+        std::array<uint8_t*, 256> writePages{};
+        uint32_t pageMapVersion = 0;
+        uint32_t mirrorMapVersion = 0; // Cartridge mirror version the PPU nametables follow
+        uint32_t chrMapVersion = 0;    // Cartridge CHR map version last reported to the PPU
+
+        void mapNametables();
+        void mapPatternBanks();
+
+        void mapPages();
+        uint8_t readIO(uint16_t address);
+        void writeIO(uint16_t address, uint8_t data);
 };
\ No newline at end of file
@@ -1,8 +1,12 @@
 #include "bus.hpp"
+#include <algorithm>
+#include <limits>
 #include "logger.hpp"
+#include "scheduler.hpp"
 
 Bus::Bus() {
     cpuRam.fill(0);
+    mapPages();
     // Initialize PPU and APU if needed, though their ctors handle most of it.
     log("BUS", "Bus initialized.");
 }
@@ -12,6 +16,9 @@ Bus::~Bus() = default;
 void Bus::insertCartridge(const std::shared_ptr<Cartridge>& cartridge) {
     this->cart = cartridge;
     ppu.connectCartridge(cartridge);
+    mapPages();
+    mapNametables();
+    mapPatternBanks();
 }
 
 void Bus::reset() {
@@ -19,6 +26,9 @@ void Bus::reset() {
     ppu.reset();
     apu.reset();
     if (cart) cart->reset();
+    mapPages();
+    mapNametables();
+    mapPatternBanks();
     dma_cycles = 0;
 }
 
@@ -28,6 +38,7 @@ void Bus::setTestMode(bool enabled) {
         testRam.resize(65536);
         std::fill(testRam.begin(), testRam.end(), 0);
     }
+    mapPages();
 }
 
 bool Bus::getIRQ() const {
@@ -36,38 +47,110 @@ bool Bus::getIRQ() const {
     return apu.irq_asserted || cartIRQ;
 }
 
-uint8_t Bus::read(uint16_t address) {
-    if (testMode) return testRam[address];
+// CPU cycles that can run before an NMI or IRQ could become pending,
+// assuming no I/O access in between.
+//
+// Deferred devices are ahead of their event by their lag; the scheduler
+// never lets that lag reach the event itself.
+int Bus::cpuCyclesUntilInterrupt(bool irq_masked) const {
+    int dots = ppu.dotsUntilVBlank();
+    if (scheduler) dots -= static_cast<int>(scheduler->ppuLag());
+    int cycles = dots > 0 ? dots / 3 : 0;
+    if (!irq_masked) {
+        int apu_cycles = apu.cyclesUntilFrameIRQ();
+        if (scheduler && apu_cycles != std::numeric_limits<int>::max()) {
+            apu_cycles -= static_cast<int>(scheduler->apuLag() / 3);
+        }
+        cycles = std::min(cycles, apu_cycles - 1);
+    }
+    return cycles;
+}
+
+void Bus::syncPPU() {
+    if (scheduler) scheduler->syncPPU();
+}
+
+void Bus::syncAPU() {
+    if (scheduler) scheduler->syncAPU();
+}
+
+void Bus::setFrameSkip(bool skip) {
+    syncPPU();
+    ppu.setFrameSkip(skip);
+}
+
+void Bus::setDeferredRenderer(DeferredRenderer* renderer) {
+    syncPPU();
+    ppu.setDeferredRenderer(renderer);
+}
+
+void Bus::mapNametables() {
+    if (!cart) return;
+    ppu.mapNametables();
+    mirrorMapVersion = cart->getMirrorVersion();
+}
+
+void Bus::mapPatternBanks() {
+    if (!cart) return;
+    ppu.chrBanksSwitched();
+    chrMapVersion = cart->getCHRMapVersion();
+}
+
+// Pages read() and write() can serve without a handler
+void Bus::mapPages() {
+    readPages.fill(nullptr);
+    writePages.fill(nullptr);
+
+    if (testMode) {
+        for (int page = 0; page < 256; ++page) {
+            readPages[page] = writePages[page] = &testRam[page << 8];
+        }
+        return;
+    }
 
+    // Internal RAM ($0000 - $1FFF), 2KB mirrored four times
+    for (int page = 0x00; page < 0x20; ++page) {
+        readPages[page] = writePages[page] = &cpuRam[(page << 8) & 0x07FF];
+    }
+
+    // Cartridge ($4100 - $FFFF). Page $40 also holds the APU/IO registers.
+    if (cart) {
+        for (int page = 0x41; page < 0x100; ++page) {
+            readPages[page] = cart->cpuReadPage(static_cast<uint16_t>(page << 8));
+            writePages[page] = cart->cpuWritePage(static_cast<uint16_t>(page << 8));
+        }
+        pageMapVersion = cart->getPRGMapVersion();
+    }
+}
+
+uint8_t Bus::readIO(uint16_t address) {
     uint8_t data = 0x00;
 
     // 1. Cartridge ($4020 - $FFFF)
     if (cart && cart->cpuRead(address, data)) {
         return data;
     }
-    // 2. Internal RAM ($0000 - $1FFF)
-    else if (address < 0x2000) {
-        return cpuRam[address & 0x07FF];
-    }
-    // 3. PPU Registers ($2000 - $3FFF)
-    else if (address < 0x4000) {
+    // 2. PPU Registers ($2000 - $3FFF)
+    else if (address >= 0x2000 && address < 0x4000) {
+        syncPPU();
         return ppu.cpuRead(address & 0x0007);
     }
-    // 4. Controller 1 ($4016)
+    // 3. Controller 1 ($4016)
     else if (address == 0x4016) {
         // Only allow reading from the input object here.
         // Reading shifts the register, so we must not do it for 4017.
         return input.read();
     }
-    // 5. Controller 2 ($4017)
+    // 4. Controller 2 ($4017)
     else if (address == 0x4017) {
         // Return 0 for unconnected second controller
         return 0x00;
     }
-    // 6. APU ($4000 - $4017)
+    // 5. APU ($4000 - $4017)
     // Note: $4015 is status, others are mostly write-only.
     else if (address < 0x4018) {
         if (address == 0x4015) {
+            syncAPU();
             return apu.cpuRead(address);
         }
     }
@@ -75,24 +158,27 @@ uint8_t Bus::read(uint16_t address) {
     return data;
 }
 
-void Bus::write(uint16_t address, uint8_t data) {
-    if (testMode) {
-        testRam[address] = data;
-        return;
+void Bus::writeIO(uint16_t address, uint8_t data) {
+    if (cart) {
+        if (address >= 0x4020) { // CHR banks and mirroring feed the PPU
+            syncPPU();
+            ppu.markLineDirty();
+        }
+        bool handled = cart->cpuWrite(address, data);
+        // Bank switches move the PRG ROM pages
+        if (cart->getPRGMapVersion() != pageMapVersion) mapPages();
+        if (cart->getMirrorVersion() != mirrorMapVersion) mapNametables();
+        if (cart->getCHRMapVersion() != chrMapVersion) mapPatternBanks();
+        if (handled) return; // Cartridge handled the write (e.g. Mapper registers)
     }
 
-    if (cart && cart->cpuWrite(address, data)) {
-        // Cartridge handled the write (e.g. Mapper registers)
-        return;
-    }
-    else if (address < 0x2000) {
-        cpuRam[address & 0x07FF] = data;
-    } 
-    else if (address < 0x4000) {
+    if (address >= 0x2000 && address < 0x4000) {
+        syncPPU();
         ppu.cpuWrite(address & 0x0007, data);
     } 
     else if (address == 0x4014) {
         // OAM DMA
+        syncPPU();
         uint16_t page = static_cast<uint16_t>(data) << 8;
         std::array<uint8_t, 256> pageData;
         for (int i = 0; i < 256; ++i) {
@@ -109,6 +195,7 @@ void Bus::write(uint16_t address, uint8_t data) {
     } 
     else if (address < 0x4018) {
         // APU Registers, including $4017 (Frame Counter)
+        syncAPU();
         apu.cpuWrite(address, data);
     }
 }
\ No newline at end of file
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+class Core;
+class Bus;
+class Cartridge;
+
+using InstrFn = void (*)(Core&);
+
+// =============================================================
+// DECODED BLOCKS
+// -----------------
+// Straight-line runs of PRG ROM instructions, decoded once with their
+// handler and operand bytes so the core can skip the bus on opcode and
+// operand fetches. A block ends at the first instruction that can
+// transfer control (branch, jump, call, return, BRK, JAM).
+// =============================================================
+
+struct DecodedInstr {
+    InstrFn handler;
+    std::uint16_t pc;
+    std::uint8_t opcode;
+    std::uint8_t length;
+    std::uint8_t operand[2];
+};
+
+struct DecodedBlock {
+    std::vector<DecodedInstr> instrs;
+
+    // Idle-loop candidates: the block branches or jumps back to its own
+    // start and only polls registers, RAM, ROM or PPUSTATUS. If one pass
+    // leaves the CPU state unchanged, every further pass is identical.
+    std::uint16_t loop_cycles = 0; // Cycles per pass, 0 if not a candidate
+    bool polls_ppu = false;        // Reads $2002 (or a mirror)
+};
+
+// =============================================================
+// BLOCK CACHE
+// -----------------
+// Keyed by PC within $8000-$FFFF under the current PRG bank mapping.
+// Any change to the mapping (mapper bank register writes, writes into
+// PRG memory) bumps Cartridge::getPRGMapVersion() and drops every block.
+// RAM ($0000-$07FF, $6000-$7FFF) and test mode are never cached.
+// =============================================================
+class BlockCache {
+    public:
+        static constexpr std::size_t MAX_BLOCK_INSTRS = 32;
+
+        // Returns the block starting at pc, decoding it on a miss, or
+        // nullptr if pc is not cacheable.
+        const DecodedBlock* lookup(Bus& bus, std::uint16_t pc);
+
+        // True while blocks handed out by lookup() are still current.
+        bool valid(const Bus& bus) const;
+
+        void flush();
+
+        // Incremented by every flush(), so dependent caches can follow.
+        std::uint32_t generation() const { return flushes; }
+
+    private:
+        void decode(Bus& bus, std::uint16_t pc, DecodedBlock& block);
+        static void classifyLoop(DecodedBlock& block);
+
+        std::vector<DecodedBlock> blocks;      // Indexed by pc - $8000
+        std::vector<std::uint16_t> filled;     // Indices of non-empty blocks
+        const Cartridge* cart = nullptr;       // Cartridge the blocks came from
+        std::uint32_t version = 0;
+        std::uint32_t flushes = 0;
+};
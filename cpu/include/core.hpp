@@ -8,6 +8,10 @@
 #include "register.hpp"
 #include "logger.hpp"
 #include "bus.hpp"
+#include "block_cache.hpp"
+#ifdef CPU_JIT
+#include "jit.hpp"
+#endif
 
 enum class Phase { STANDBY, FETCH, OPR_FETCH, READ, OPERATION, WRITE, INTERRUPT, ERROR };
 
@@ -21,16 +25,35 @@ class Core {
         Phase core_phase;
 
         // Variables
-        uint8_t opcode, sp, status;
-        uint16_t pc_val, lo, hi;
+        uint8_t opcode;
+        uint16_t lo, hi;
+
+        // Pre-decoded PRG ROM blocks. While an entry executes, fetch()
+        // serves its operand bytes from operand_ptr instead of the bus.
+        BlockCache block_cache;
+        const DecodedBlock* block_cur = nullptr;
+        const DecodedInstr* block_next = nullptr;
+        const DecodedInstr* block_end = nullptr;
+        const std::uint8_t* operand_ptr = nullptr;
+        const std::uint8_t* operand_end = nullptr;
+
+        // Idle-loop fast-forward. A snapshot is taken at the head of a
+        // candidate loop; when the next pass arrives in the same state the
+        // remaining passes up to the next event are charged in one step.
+        bool idle_armed = false;
+        CpuRegisters idle_regs;
+        std::uint8_t idle_status = 0; // PPUSTATUS at the snapshot
+
+#ifdef CPU_JIT
+        Jit jit;
+#endif
+
+        void interrupt(std::uint16_t vector);
+        const DecodedInstr* nextDecoded();
+        int skipIdleLoop();
 
     public:
-        Register a;
-        Register x;
-        Register y;
-        Register s;
-        Register pc;
-        Register p;
+        CpuRegisters regs;
         
         std::array<OpHandler, 256> instr_table;
         
@@ -50,11 +73,16 @@ class Core {
 
         void init();
         void step();
+        int execDecoded(const DecodedInstr& ins); // Runs one entry at ins.pc, returns its cycles
         
-        std::uint8_t read(std::uint16_t address) const;
-        void write(std::uint16_t address, std::uint8_t value);
+        std::uint8_t read(std::uint16_t address) const { return bus->read(address); }
+        void write(std::uint16_t address, std::uint8_t value) { bus->write(address, value); }
         
-        std::uint8_t fetch();
+        std::uint8_t fetch() {
+            regs.pc++;
+            if (operand_ptr != operand_end) return *operand_ptr++;
+            return bus->read(static_cast<std::uint16_t>(regs.pc - 1));
+        }
         std::uint16_t fetchWord();
         
         void setStatusFlag(StatusFlag flag, bool value);
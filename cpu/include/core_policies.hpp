@@ -21,8 +21,8 @@ struct IMP {
 struct IMM {
     static constexpr bool is_implied = false;
     static std::uint16_t getAddr(Core& core) {
-        std::uint16_t address = static_cast<std::uint16_t>(core.pc.getValue());
-        core.pc.setValue(static_cast<std::uint64_t>(address + 1));
+        std::uint16_t address = core.regs.pc;
+        core.regs.pc = static_cast<std::uint16_t>(address + 1);
         return address;
     }
 };
@@ -35,14 +35,14 @@ struct ZP {
 struct ZPX {
     static constexpr bool is_implied = false;
     static std::uint16_t getAddr(Core& core) {
-        return static_cast<std::uint16_t>((core.fetch() + static_cast<std::uint8_t>(core.x.getValue())) & 0xFF);
+        return static_cast<std::uint16_t>((core.fetch() + core.regs.x) & 0xFF);
     }
 };
 
 struct ZPY {
     static constexpr bool is_implied = false;
     static std::uint16_t getAddr(Core& core) {
-        return static_cast<std::uint16_t>((core.fetch() + static_cast<std::uint8_t>(core.y.getValue())) & 0xFF);
+        return static_cast<std::uint16_t>((core.fetch() + core.regs.y) & 0xFF);
     }
 };
 
@@ -53,12 +53,12 @@ struct ABS {
 
 struct ABSX {
     static constexpr bool is_implied = false;
-    static std::uint16_t getAddr(Core& core) { return static_cast<std::uint16_t>(core.fetchWord() + static_cast<std::uint16_t>(core.x.getValue())); }
+    static std::uint16_t getAddr(Core& core) { return static_cast<std::uint16_t>(core.fetchWord() + core.regs.x); }
 };
 
 struct ABSY {
     static constexpr bool is_implied = false;
-    static std::uint16_t getAddr(Core& core) { return static_cast<std::uint16_t>(core.fetchWord() + static_cast<std::uint16_t>(core.y.getValue())); }
+    static std::uint16_t getAddr(Core& core) { return static_cast<std::uint16_t>(core.fetchWord() + core.regs.y); }
 };
 
 struct IND {
@@ -89,7 +89,7 @@ struct IND {
 struct INDX {
     static constexpr bool is_implied = false;
     static std::uint16_t getAddr(Core& core) {
-        std::uint8_t ptr = static_cast<std::uint8_t>((core.fetch() + static_cast<std::uint8_t>(core.x.getValue())) & 0xFF);
+        std::uint8_t ptr = static_cast<std::uint8_t>((core.fetch() + core.regs.x) & 0xFF);
         std::uint16_t low = core.read(ptr);
         std::uint16_t high = core.read((ptr + 1) & 0xFF);
         return static_cast<std::uint16_t>((high << 8) | low);
@@ -102,7 +102,7 @@ struct INDY {
         std::uint8_t ptr = core.fetch();
         std::uint16_t low = core.read(ptr);
         std::uint16_t high = core.read((ptr + 1) & 0xFF);
-        return static_cast<std::uint16_t>(((high << 8) | low) + static_cast<std::uint16_t>(core.y.getValue()));
+        return static_cast<std::uint16_t>(((high << 8) | low) + core.regs.y);
     }
 };
 
@@ -110,7 +110,7 @@ struct REL {
     static constexpr bool is_implied = false;
     static std::uint16_t getAddr(Core& core) {
         std::int8_t offset = static_cast<std::int8_t>(core.fetch());
-        return static_cast<std::uint16_t>(core.pc.getValue() + offset);
+        return static_cast<std::uint16_t>(core.regs.pc + offset);
     }
 };
 
@@ -125,8 +125,12 @@ struct ACC {
 
 template <typename MODE, typename OPERATION>
 void ExecRead(Core& core) {
-    std::uint16_t addr = MODE::getAddr(core);
-    std::uint8_t  val  = core.read(addr);
+    std::uint8_t val;
+    if constexpr (std::is_same_v<MODE, IMM>) {
+        val = core.fetch(); // Operand byte is the value (may come from a decoded block)
+    } else {
+        val = core.read(MODE::getAddr(core));
+    }
     OPERATION::exec(core, val);
 }
 
@@ -140,8 +144,8 @@ void ExecWrite(Core& core) {
 template <typename MODE, typename OPERATION>
 void ExecRMW(Core& core) {
     if constexpr (std::is_same_v<MODE, ACC>) {
-        std::uint8_t result = OPERATION::calc(core, static_cast<std::uint8_t>(core.a.getValue()));
-        core.a.setValue(result);
+        std::uint8_t result = OPERATION::calc(core, core.regs.a);
+        core.regs.a = result;
     } else {
         std::uint16_t addr = MODE::getAddr(core);
         std::uint8_t  val  = core.read(addr);
@@ -155,7 +159,7 @@ void ExecBranch(Core& core) {
     // REL mode returns the TARGET address (not the offset) in this implementation.
     std::uint16_t target = REL::getAddr(core);
     if (CONDITION::check(core)) {
-        core.pc.setValue(target);
+        core.regs.pc = target;
         // Note: Real hardware adds extra cycles when branching and if a page crosses.
     }
 }
@@ -166,31 +170,28 @@ void ExecBranch(Core& core) {
 
 struct Op_LDA {
     static void exec(Core& core, std::uint8_t v) {
-        core.a.setValue(v);
-        core.setStatusFlag(Core::StatusFlag::Z, v == 0);
-        core.setStatusFlag(Core::StatusFlag::N, (v & 0x80) != 0);
+        core.regs.a = v;
+        core.regs.setZN(v);
     }
 };
 
 struct Op_LDX {
     static void exec(Core& core, std::uint8_t v) {
-        core.x.setValue(v);
-        core.setStatusFlag(Core::StatusFlag::Z, v == 0);
-        core.setStatusFlag(Core::StatusFlag::N, (v & 0x80) != 0);
+        core.regs.x = v;
+        core.regs.setZN(v);
     }
 };
 
 struct Op_LDY {
     static void exec(Core& core, std::uint8_t v) {
-        core.y.setValue(v);
-        core.setStatusFlag(Core::StatusFlag::Z, v == 0);
-        core.setStatusFlag(Core::StatusFlag::N, (v & 0x80) != 0);
+        core.regs.y = v;
+        core.regs.setZN(v);
     }
 };
 
-struct Src_A { static std::uint8_t get(Core& core) { return static_cast<std::uint8_t>(core.a.getValue()); } };
-struct Src_X { static std::uint8_t get(Core& core) { return static_cast<std::uint8_t>(core.x.getValue()); } };
-struct Src_Y { static std::uint8_t get(Core& core) { return static_cast<std::uint8_t>(core.y.getValue()); } };
+struct Src_A { static std::uint8_t get(Core& core) { return core.regs.a; } };
+struct Src_X { static std::uint8_t get(Core& core) { return core.regs.x; } };
+struct Src_Y { static std::uint8_t get(Core& core) { return core.regs.y; } };
 
 // =============================================================
 // OPERATIONS: LOGICAL
@@ -198,38 +199,35 @@ struct Src_Y { static std::uint8_t get(Core& core) { return static_cast<std::uin
 
 struct Op_AND {
     static void exec(Core& core, std::uint8_t v) {
-        auto newv = core.a.getValue() & v;
-        core.a.setValue(newv);
-        core.setStatusFlag(Core::StatusFlag::Z, static_cast<std::uint8_t>(newv) == 0);
-        core.setStatusFlag(Core::StatusFlag::N, (static_cast<std::uint8_t>(newv) & 0x80) != 0);
+        auto newv = core.regs.a & v;
+        core.regs.a = newv;
+        core.regs.setZN(newv);
     } 
 };
 
 struct Op_ORA {
     static void exec(Core& core, std::uint8_t v) {
-        auto newv = core.a.getValue() | v;
-        core.a.setValue(newv);
-        core.setStatusFlag(Core::StatusFlag::Z, static_cast<std::uint8_t>(newv) == 0);
-        core.setStatusFlag(Core::StatusFlag::N, (static_cast<std::uint8_t>(newv) & 0x80) != 0);
+        auto newv = core.regs.a | v;
+        core.regs.a = newv;
+        core.regs.setZN(newv);
     } 
 };
 
 struct Op_EOR {
     static void exec(Core& core, std::uint8_t v) {
-        auto newv = core.a.getValue() ^ v;
-        core.a.setValue(newv);
-        core.setStatusFlag(Core::StatusFlag::Z, static_cast<std::uint8_t>(newv) == 0);
-        core.setStatusFlag(Core::StatusFlag::N, (static_cast<std::uint8_t>(newv) & 0x80) != 0);
+        auto newv = core.regs.a ^ v;
+        core.regs.a = newv;
+        core.regs.setZN(newv);
     } 
 };
 
 struct Op_BIT {
     static void exec(Core& core, std::uint8_t v) {
-        std::uint8_t a = static_cast<std::uint8_t>(core.a.getValue());
+        std::uint8_t a = core.regs.a;
         std::uint8_t res = a & v;
-        core.setStatusFlag(Core::StatusFlag::Z, res == 0);
-        core.setStatusFlag(Core::StatusFlag::N, (v & 0x80) != 0); // Bit 7 of Memory
-        core.setStatusFlag(Core::StatusFlag::V, (v & 0x40) != 0); // Bit 6 of Memory
+        core.regs.setZ(res == 0);
+        core.regs.setN((v & 0x80) != 0); // Bit 7 of Memory
+        core.regs.v = (v & 0x40) != 0; // Bit 6 of Memory
     }
 };
 
@@ -237,161 +235,166 @@ struct Op_BIT {
 // OPERATIONS: MATH
 // =============================================================
 
+// 2A03 add with carry. The NES CPU has its decimal mode disconnected, so
+// this binary path is all ADC, SBC and their illegal combos compile to
+// when NES is set; the NMOS decimal paths below are only built without it.
+inline void AddWithCarry(Core& core, std::uint8_t v) {
+    std::uint8_t a = core.regs.a;
+    std::uint16_t sum = a + v + (core.regs.c ? 1 : 0);
+    std::uint8_t result8 = static_cast<std::uint8_t>(sum);
+    core.regs.c = sum > 0xFF;
+    core.regs.v = (~(a ^ v) & (a ^ result8) & 0x80) != 0;
+    core.regs.a = result8;
+    core.regs.setZN(result8);
+}
+
 struct Op_ADC {
     static void exec(Core& core, std::uint8_t v) {
-        std::uint8_t a = static_cast<std::uint8_t>(core.a.getValue());
-        std::uint8_t carry = core.getStatusFlag(Core::StatusFlag::C) ? 1 : 0;
-        
-        // 1. Calculate Binary Sum
-        std::uint16_t binarySum = a + v + carry;
+        if constexpr (!NES) {
+            if (core.regs.d) {
+                std::uint8_t a = core.regs.a;
+                std::uint8_t carry = core.regs.c ? 1 : 0;
 
-        if (core.getStatusFlag(Core::StatusFlag::D) && !NES) {
-            // --- DECIMAL MODE LOGIC (NMOS 6502) ---
+                // 1. Calculate Binary Sum
+                std::uint16_t binarySum = a + v + carry;
+
+                // --- DECIMAL MODE LOGIC (NMOS 6502) ---
             
-            // 2. Z Flag: Derived directly from the BINARY sum
-            // This is a known hardware quirk. Z ignores the BCD fixups.
-            core.setStatusFlag(Core::StatusFlag::Z, (binarySum & 0xFF) == 0);
+                // 2. Z Flag: Derived directly from the BINARY sum
+                // This is a known hardware quirk. Z ignores the BCD fixups.
+                core.regs.setZ((binarySum & 0xFF) == 0);
 
-            // 3. Prepare Intermediate Sum for N & V Flags
-            std::uint8_t al = (a & 0x0F) + (v & 0x0F) + carry;
-            std::uint8_t diff = (al > 9) ? 0x06 : 0;
+                // 3. Prepare Intermediate Sum for N & V Flags
+                std::uint8_t al = (a & 0x0F) + (v & 0x0F) + carry;
+                std::uint8_t diff = (al > 9) ? 0x06 : 0;
             
-            std::uint16_t nCalc = binarySum + diff;
+                std::uint16_t nCalc = binarySum + diff;
             
-            // "Double Carry Suppression" (Test 64/789 Fix)
-            // If both Binary and Correction generated half-carries, suppress the 2nd one.
-            if ((al > 15) && (((binarySum & 0x0F) + diff) > 15)) {
-                nCalc -= 0x10;
-            }
+                // "Double Carry Suppression" (Test 64/789 Fix)
+                // If both Binary and Correction generated half-carries, suppress the 2nd one.
+                if ((al > 15) && (((binarySum & 0x0F) + diff) > 15)) {
+                    nCalc -= 0x10;
+                }
             
-            // 4. N Flag: Derived from Intermediate Sum
-            core.setStatusFlag(Core::StatusFlag::N, (nCalc & 0x80) != 0);
-
-            // 5. V Flag: Derived from Intermediate Sum (Test 703 Fix)
-            // We check if (A_sign equals V_sign) AND (A_sign does NOT equal Result_sign)
-            // Result here is the Intermediate Sum (nCalc) masked to 8 bits.
-            std::uint8_t intermediate8 = static_cast<std::uint8_t>(nCalc);
-            bool overflow = (~(a ^ v) & (a ^ intermediate8) & 0x80) != 0;
-            core.setStatusFlag(Core::StatusFlag::V, overflow);
-
-            // 6. Final BCD Fixup (Calculates Final Value and C Flag)
-            // Re-calculate clean nibbles for storage
-            al = (a & 0x0F) + (v & 0x0F) + carry;
-            std::uint8_t ah = (a >> 4) + (v >> 4);
+                // 4. N Flag: Derived from Intermediate Sum
+                core.regs.setN((nCalc & 0x80) != 0);
+
+                // 5. V Flag: Derived from Intermediate Sum (Test 703 Fix)
+                // We check if (A_sign equals V_sign) AND (A_sign does NOT equal Result_sign)
+                // Result here is the Intermediate Sum (nCalc) masked to 8 bits.
+                std::uint8_t intermediate8 = static_cast<std::uint8_t>(nCalc);
+                bool overflow = (~(a ^ v) & (a ^ intermediate8) & 0x80) != 0;
+                core.regs.v = overflow;
+
+                // 6. Final BCD Fixup (Calculates Final Value and C Flag)
+                // Re-calculate clean nibbles for storage
+                al = (a & 0x0F) + (v & 0x0F) + carry;
+                std::uint8_t ah = (a >> 4) + (v >> 4);
             
-            if (al > 9) {
-                al += 6;
-                ah++; 
-            }
+                if (al > 9) {
+                    al += 6;
+                    ah++; 
+                }
             
-            if (ah > 9) {
-                ah += 6;
-            }
+                if (ah > 9) {
+                    ah += 6;
+                }
             
-            // C Flag
-            core.setStatusFlag(Core::StatusFlag::C, ah > 0x0F);
+                // C Flag
+                core.regs.c = ah > 0x0F;
             
-            // Store Result
-            core.a.setValue((ah << 4) | (al & 0x0F));
-
-        } else {
-            // --- BINARY MODE LOGIC ---
-            core.setStatusFlag(Core::StatusFlag::C, binarySum > 0xFF);
-            std::uint8_t result8 = static_cast<std::uint8_t>(binarySum);
-            bool overflow = (~(a ^ v) & (a ^ result8) & 0x80) != 0;
-            core.setStatusFlag(Core::StatusFlag::V, overflow);
-            
-            core.a.setValue(result8);
-            core.setStatusFlag(Core::StatusFlag::Z, result8 == 0);
-            core.setStatusFlag(Core::StatusFlag::N, (result8 & 0x80) != 0);
+                // Store Result
+                core.regs.a = (ah << 4) | (al & 0x0F);
+                return;
+            }
         }
+
+        // --- BINARY MODE LOGIC ---
+        AddWithCarry(core, v);
     } 
 };
 
 struct Op_SBC {
     static void exec(Core& core, std::uint8_t v) {
-        // Fetch A and Carry
-        std::uint8_t a = static_cast<std::uint8_t>(core.a.getValue());
-        std::uint8_t c = core.getStatusFlag(Core::StatusFlag::C) ? 1 : 0;
-        
-        // 1. Binary Subtraction (Used for Flags and result foundation)
-        // Formula: A - M - (1 - C)
-        std::uint16_t diff = a - v - (1 - c);
+        if constexpr (!NES) {
+            if (core.regs.d) {
+                // Fetch A and Carry
+                std::uint8_t a = core.regs.a;
+                std::uint8_t c = core.regs.c ? 1 : 0;
 
-        // 2. Set Flags (Same for Binary and Decimal on NMOS 6502)
-        // C Flag: In 6502, C=1 means NO borrow (Result >= 0), C=0 means Borrow (Result < 0)
-        core.setStatusFlag(Core::StatusFlag::C, diff <= 0xFF);
-        
-        // V Flag: Overflow if (Pos - Neg = Neg) or (Neg - Pos = Pos)
-        // We check signs of A, ~M (the subtraction operand), and Result
-        bool overflow = ((a ^ v) & (a ^ diff) & 0x80) != 0;
-        core.setStatusFlag(Core::StatusFlag::V, overflow);
-        
-        // Z and N are based on the binary result
-        core.setStatusFlag(Core::StatusFlag::Z, (diff & 0xFF) == 0);
-        core.setStatusFlag(Core::StatusFlag::N, (diff & 0x80) != 0);
+                // 1. Binary Subtraction (Used for Flags and result foundation)
+                // Formula: A - M - (1 - C)
+                std::uint16_t diff = a - v - (1 - c);
 
-        if (core.getStatusFlag(Core::StatusFlag::D) && !NES) {
-            // --- DECIMAL MODE LOGIC ---
-            
-            // We must treat nibbles independently to prevent borrow propagation
-            // from the low correction corrupting the high nibble.
+                // 2. Set Flags (Same for Binary and Decimal on NMOS 6502)
+                // C Flag: In 6502, C=1 means NO borrow (Result >= 0), C=0 means Borrow (Result < 0)
+                core.regs.c = diff <= 0xFF;
+
+                // V Flag: Overflow if (Pos - Neg = Neg) or (Neg - Pos = Pos)
+                core.regs.v = ((a ^ v) & (a ^ diff) & 0x80) != 0;
+
+                // Z and N are based on the binary result
+                core.regs.setZN(static_cast<std::uint8_t>(diff));
+
+                // --- DECIMAL MODE LOGIC ---
             
-            // Re-calculate nibble differences to detect borrows
-            std::uint16_t lowDiff = (a & 0x0F) - (v & 0x0F) - (1 - c);
-            std::uint16_t highDiff = (a >> 4) - (v >> 4) - ((lowDiff > 0xF) ? 1 : 0);
+                // We must treat nibbles independently to prevent borrow propagation
+                // from the low correction corrupting the high nibble.
             
-            std::uint8_t lowNibble = diff & 0x0F;
-            std::uint8_t highNibble = (diff >> 4) & 0x0F;
-
-            // Apply Corrections
-            // If the low nibble required a borrow, subtract 6
-            if (lowDiff > 0xF) { 
-                lowNibble = (lowNibble - 6) & 0x0F;
-            }
+                // Re-calculate nibble differences to detect borrows
+                std::uint16_t lowDiff = (a & 0x0F) - (v & 0x0F) - (1 - c);
+                std::uint16_t highDiff = (a >> 4) - (v >> 4) - ((lowDiff > 0xF) ? 1 : 0);
             
-            // If the high nibble required a borrow, subtract 6
-            if (highDiff > 0xF) { 
-                highNibble = (highNibble - 6) & 0x0F;
-            }
+                std::uint8_t lowNibble = diff & 0x0F;
+                std::uint8_t highNibble = (diff >> 4) & 0x0F;
+
+                // Apply Corrections
+                // If the low nibble required a borrow, subtract 6
+                if (lowDiff > 0xF) { 
+                    lowNibble = (lowNibble - 6) & 0x0F;
+                }
             
-            // Combine
-            core.a.setValue((highNibble << 4) | lowNibble);
+                // If the high nibble required a borrow, subtract 6
+                if (highDiff > 0xF) { 
+                    highNibble = (highNibble - 6) & 0x0F;
+                }
             
-        } else {
-            // --- BINARY MODE LOGIC ---
-            core.a.setValue(static_cast<std::uint8_t>(diff));
+                // Combine
+                core.regs.a = (highNibble << 4) | lowNibble;
+                return;
+            }
         }
+
+        // --- BINARY MODE LOGIC ---
+        // A - M - (1 - C) == A + ~M + C, including the C (no borrow) and V flags.
+        AddWithCarry(core, static_cast<std::uint8_t>(~v));
     }
 };
 
 struct Op_CMP {
     static void exec(Core& core, std::uint8_t v) {
-        std::uint8_t reg = static_cast<std::uint8_t>(core.a.getValue());
+        std::uint8_t reg = core.regs.a;
         std::uint8_t res = reg - v;
-        core.setStatusFlag(Core::StatusFlag::C, reg >= v);
-        core.setStatusFlag(Core::StatusFlag::Z, reg == v);
-        core.setStatusFlag(Core::StatusFlag::N, (res & 0x80) != 0);
+        core.regs.c = reg >= v;
+        core.regs.setZN(res); // reg == v exactly when res == 0
     }
 };
 
 struct Op_CPX {
     static void exec(Core& core, std::uint8_t v) {
-        std::uint8_t reg = static_cast<std::uint8_t>(core.x.getValue());
+        std::uint8_t reg = core.regs.x;
         std::uint8_t res = reg - v;
-        core.setStatusFlag(Core::StatusFlag::C, reg >= v);
-        core.setStatusFlag(Core::StatusFlag::Z, reg == v);
-        core.setStatusFlag(Core::StatusFlag::N, (res & 0x80) != 0);
+        core.regs.c = reg >= v;
+        core.regs.setZN(res); // reg == v exactly when res == 0
     }
 };
 
 struct Op_CPY {
     static void exec(Core& core, std::uint8_t v) {
-        std::uint8_t reg = static_cast<std::uint8_t>(core.y.getValue());
+        std::uint8_t reg = core.regs.y;
         std::uint8_t res = reg - v;
-        core.setStatusFlag(Core::StatusFlag::C, reg >= v);
-        core.setStatusFlag(Core::StatusFlag::Z, reg == v);
-        core.setStatusFlag(Core::StatusFlag::N, (res & 0x80) != 0);
+        core.regs.c = reg >= v;
+        core.regs.setZN(res); // reg == v exactly when res == 0
     }
 };
 
@@ -402,8 +405,7 @@ struct Op_CPY {
 struct Op_INC {
     static std::uint8_t calc(Core& core, std::uint8_t v) {
         std::uint8_t r = v + 1;
-        core.setStatusFlag(Core::StatusFlag::Z, r == 0);
-        core.setStatusFlag(Core::StatusFlag::N, (r & 0x80) != 0);
+        core.regs.setZN(r);
         return r; 
     } 
 };
@@ -411,50 +413,45 @@ struct Op_INC {
 struct Op_DEC {
     static std::uint8_t calc(Core& core, std::uint8_t v) {
         std::uint8_t r = v - 1;
-        core.setStatusFlag(Core::StatusFlag::Z, r == 0);
-        core.setStatusFlag(Core::StatusFlag::N, (r & 0x80) != 0);
+        core.regs.setZN(r);
         return r; 
     } 
 };
 
 struct Op_ASL {
     static std::uint8_t calc(Core& core, std::uint8_t v) {
-        core.setStatusFlag(Core::StatusFlag::C, (v & 0x80) != 0);
+        core.regs.c = (v & 0x80) != 0;
         std::uint8_t r = v << 1;
-        core.setStatusFlag(Core::StatusFlag::Z, r == 0);
-        core.setStatusFlag(Core::StatusFlag::N, (r & 0x80) != 0);
+        core.regs.setZN(r);
         return r; 
     } 
 };
 
 struct Op_LSR {
     static std::uint8_t calc(Core& core, std::uint8_t v) {
-        core.setStatusFlag(Core::StatusFlag::C, (v & 0x01) != 0);
+        core.regs.c = (v & 0x01) != 0;
         std::uint8_t r = v >> 1;
-        core.setStatusFlag(Core::StatusFlag::Z, r == 0);
-        core.setStatusFlag(Core::StatusFlag::N, false); // Bit 7 always 0
+        core.regs.setZN(r); // Bit 7 always 0
         return r;
     }
 };
 
 struct Op_ROL {
     static std::uint8_t calc(Core& core, std::uint8_t v) {
-        bool oldCarry = core.getStatusFlag(Core::StatusFlag::C);
-        core.setStatusFlag(Core::StatusFlag::C, (v & 0x80) != 0);
+        bool oldCarry = core.regs.c;
+        core.regs.c = (v & 0x80) != 0;
         std::uint8_t r = (v << 1) | (oldCarry ? 1 : 0);
-        core.setStatusFlag(Core::StatusFlag::Z, r == 0);
-        core.setStatusFlag(Core::StatusFlag::N, (r & 0x80) != 0);
+        core.regs.setZN(r);
         return r;
     }
 };
 
 struct Op_ROR {
     static std::uint8_t calc(Core& core, std::uint8_t v) {
-        bool oldCarry = core.getStatusFlag(Core::StatusFlag::C);
-        core.setStatusFlag(Core::StatusFlag::C, (v & 0x01) != 0);
+        bool oldCarry = core.regs.c;
+        core.regs.c = (v & 0x01) != 0;
         std::uint8_t r = (v >> 1) | (oldCarry ? 0x80 : 0);
-        core.setStatusFlag(Core::StatusFlag::Z, r == 0);
-        core.setStatusFlag(Core::StatusFlag::N, (r & 0x80) != 0);
+        core.regs.setZN(r);
         return r;
     }
 };
@@ -463,53 +460,53 @@ struct Op_ROR {
 // OPERATIONS: BRANCHING
 // =============================================================
 
-struct Cond_BPL { static bool check(Core& c) { return !c.getStatusFlag(Core::StatusFlag::N); } };
-struct Cond_BMI { static bool check(Core& c) { return c.getStatusFlag(Core::StatusFlag::N); } };
-struct Cond_BVC { static bool check(Core& c) { return !c.getStatusFlag(Core::StatusFlag::V); } };
-struct Cond_BVS { static bool check(Core& c) { return c.getStatusFlag(Core::StatusFlag::V); } };
-struct Cond_BCC { static bool check(Core& c) { return !c.getStatusFlag(Core::StatusFlag::C); } };
-struct Cond_BCS { static bool check(Core& c) { return c.getStatusFlag(Core::StatusFlag::C); } };
-struct Cond_BNE { static bool check(Core& c) { return !c.getStatusFlag(Core::StatusFlag::Z); } };
-struct Cond_BEQ { static bool check(Core& c) { return c.getStatusFlag(Core::StatusFlag::Z); } };
+struct Cond_BPL { static bool check(Core& c) { return !c.regs.getN(); } };
+struct Cond_BMI { static bool check(Core& c) { return c.regs.getN(); } };
+struct Cond_BVC { static bool check(Core& c) { return !c.regs.v; } };
+struct Cond_BVS { static bool check(Core& c) { return c.regs.v; } };
+struct Cond_BCC { static bool check(Core& c) { return !c.regs.c; } };
+struct Cond_BCS { static bool check(Core& c) { return c.regs.c; } };
+struct Cond_BNE { static bool check(Core& c) { return !c.regs.getZ(); } };
+struct Cond_BEQ { static bool check(Core& c) { return c.regs.getZ(); } };
 
 // =============================================================
 // OPERATIONS: TRANSFERS & FLAGS (Implied Mode)
 // =============================================================
 
 struct Op_TAX { static void exec(Core& c, std::uint8_t) {
-    std::uint8_t v = static_cast<std::uint8_t>(c.a.getValue()); 
-    c.x.setValue(v); 
-    c.setStatusFlag(Core::StatusFlag::Z, v==0); c.setStatusFlag(Core::StatusFlag::N, (v&0x80)!=0); } };
+    std::uint8_t v = c.regs.a; 
+    c.regs.x = v; 
+    c.regs.setZN(v); } };
 
 struct Op_TAY { static void exec(Core& c, std::uint8_t) {
-    std::uint8_t v = static_cast<std::uint8_t>(c.a.getValue()); 
-    c.y.setValue(v); 
-    c.setStatusFlag(Core::StatusFlag::Z, v==0); c.setStatusFlag(Core::StatusFlag::N, (v&0x80)!=0); } };
+    std::uint8_t v = c.regs.a; 
+    c.regs.y = v; 
+    c.regs.setZN(v); } };
 
 struct Op_TXA { static void exec(Core& c, std::uint8_t) {
-    std::uint8_t v = static_cast<std::uint8_t>(c.x.getValue()); 
-    c.a.setValue(v); 
-    c.setStatusFlag(Core::StatusFlag::Z, v==0); c.setStatusFlag(Core::StatusFlag::N, (v&0x80)!=0); } };
+    std::uint8_t v = c.regs.x; 
+    c.regs.a = v; 
+    c.regs.setZN(v); } };
 
 struct Op_TYA { static void exec(Core& c, std::uint8_t) {
-    std::uint8_t v = static_cast<std::uint8_t>(c.y.getValue()); 
-    c.a.setValue(v); 
-    c.setStatusFlag(Core::StatusFlag::Z, v==0); c.setStatusFlag(Core::StatusFlag::N, (v&0x80)!=0); } };
+    std::uint8_t v = c.regs.y; 
+    c.regs.a = v; 
+    c.regs.setZN(v); } };
 
 struct Op_TSX { static void exec(Core& c, std::uint8_t) {
-    std::uint8_t v = static_cast<std::uint8_t>(c.s.getValue()); 
-    c.x.setValue(v); 
-    c.setStatusFlag(Core::StatusFlag::Z, v==0); c.setStatusFlag(Core::StatusFlag::N, (v&0x80)!=0); } };
+    std::uint8_t v = c.regs.s; 
+    c.regs.x = v; 
+    c.regs.setZN(v); } };
 
-struct Op_TXS { static void exec(Core& c, std::uint8_t) { c.s.setValue(c.x.getValue()); } };
+struct Op_TXS { static void exec(Core& c, std::uint8_t) { c.regs.s = c.regs.x; } };
 
-struct Op_CLC { static void exec(Core& c, std::uint8_t) { c.setStatusFlag(Core::StatusFlag::C, false); } };
-struct Op_SEC { static void exec(Core& c, std::uint8_t) { c.setStatusFlag(Core::StatusFlag::C, true); } };
-struct Op_CLI { static void exec(Core& c, std::uint8_t) { c.setStatusFlag(Core::StatusFlag::I, false); } };
-struct Op_SEI { static void exec(Core& c, std::uint8_t) { c.setStatusFlag(Core::StatusFlag::I, true); } };
-struct Op_CLV { static void exec(Core& c, std::uint8_t) { c.setStatusFlag(Core::StatusFlag::V, false); } };
-struct Op_CLD { static void exec(Core& c, std::uint8_t) { c.setStatusFlag(Core::StatusFlag::D, false); } };
-struct Op_SED { static void exec(Core& c, std::uint8_t) { c.setStatusFlag(Core::StatusFlag::D, true); } };
+struct Op_CLC { static void exec(Core& c, std::uint8_t) { c.regs.c = false; } };
+struct Op_SEC { static void exec(Core& c, std::uint8_t) { c.regs.c = true; } };
+struct Op_CLI { static void exec(Core& c, std::uint8_t) { c.regs.i = false; } };
+struct Op_SEI { static void exec(Core& c, std::uint8_t) { c.regs.i = true; } };
+struct Op_CLV { static void exec(Core& c, std::uint8_t) { c.regs.v = false; } };
+struct Op_CLD { static void exec(Core& c, std::uint8_t) { c.regs.d = false; } };
+struct Op_SED { static void exec(Core& c, std::uint8_t) { c.regs.d = true; } };
 
 // =============================================================
 // OPERATIONS: CONTROL FLOW & STACK
@@ -518,39 +515,33 @@ struct Op_SED { static void exec(Core& c, std::uint8_t) { c.setStatusFlag(Core::
 // Helper for Stack Pushes
 struct StackOps {
     static void push(Core& c, std::uint8_t val) {
-        std::uint8_t sp = static_cast<std::uint8_t>(c.s.getValue());
+        std::uint8_t sp = c.regs.s;
         c.write(0x0100 | sp, val);
-        c.s.setValue(sp - 1);
+        c.regs.s = sp - 1;
     }
     static std::uint8_t pop(Core& c) {
-        std::uint8_t sp = static_cast<std::uint8_t>(c.s.getValue()) + 1;
-        c.s.setValue(sp);
+        std::uint8_t sp = c.regs.s + 1;
+        c.regs.s = sp;
         return c.read(0x0100 | sp);
     }
 };
 
-struct Op_PHA { static void exec(Core& c, std::uint8_t) { StackOps::push(c, static_cast<std::uint8_t>(c.a.getValue())); } };
+struct Op_PHA { static void exec(Core& c, std::uint8_t) { StackOps::push(c, c.regs.a); } };
 
 struct Op_PHP { static void exec(Core& c, std::uint8_t) {
     // PHP sets Bit 4 (Break) AND Bit 5 (Unused) when pushing to stack
-    StackOps::push(c, static_cast<std::uint8_t>(c.p.getValue()) | 0x30);
+    StackOps::push(c, c.regs.getP() | 0x30);
 } };
 
 struct Op_PLA { static void exec(Core& c, std::uint8_t) {
     std::uint8_t v = StackOps::pop(c);
-    c.a.setValue(v);
-    c.setStatusFlag(Core::StatusFlag::Z, v==0); 
-    c.setStatusFlag(Core::StatusFlag::N, (v&0x80)!=0);
+    c.regs.a = v;
+    c.regs.setZN(v);
 } };
 
 struct Op_PLP { static void exec(Core& c, std::uint8_t) {
-    // PLP ignores Bit 4 and Bit 5 from the stack value
-    std::uint8_t v = StackOps::pop(c);
-    std::uint8_t current = static_cast<std::uint8_t>(c.p.getValue());
-    // Keep bits 5 and 4 of current, overwrite rest from stack
-    // (Actually 6502 implementation details vary, but bit 5 is usually ignored on set)
-    // The safest emulator way is: P = (stack & ~0x30) | (current & 0x30) OR just raw set but ignore effect of B
-    c.p.setValue((v & ~0x30) | (current & 0x30));
+    // PLP ignores Bit 4 and Bit 5 from the stack value (setP drops them)
+    c.regs.setP(StackOps::pop(c));
 } };
 
 // JMP Absolute: Sets PC to the effective address
@@ -561,7 +552,7 @@ struct Op_JMP {
 template <typename MODE>
 void ExecJMP(Core& core) {
     std::uint16_t target = MODE::getAddr(core);
-    core.pc.setValue(target);
+    core.regs.pc = target;
 }
 
 struct Op_JSR {
@@ -569,13 +560,13 @@ struct Op_JSR {
 };
 // Specialized JSR Logic
 // JSR pushes PC+2 (which is effectively the address of the last byte of the JSR instruction)
-void ExecJSR(Core& core) {
+inline void ExecJSR(Core& core) {
     std::uint16_t target = core.fetchWord(); // This fetches the target address (PC is now JSR + 3)
     // We need to push PC - 1 (The address of the 2nd byte of the address)
-    std::uint16_t pushPC = static_cast<std::uint16_t>(core.pc.getValue()) - 1;
+    std::uint16_t pushPC = core.regs.pc - 1;
     StackOps::push(core, static_cast<std::uint8_t>((pushPC >> 8) & 0xFF));
     StackOps::push(core, static_cast<std::uint8_t>(pushPC & 0xFF));
-    core.pc.setValue(target);
+    core.regs.pc = target;
 }
 
 struct Op_RTS {
@@ -583,36 +574,34 @@ struct Op_RTS {
         std::uint16_t low = StackOps::pop(core);
         std::uint16_t high = StackOps::pop(core);
         std::uint16_t addr = static_cast<std::uint16_t>((high << 8) | low);
-        core.pc.setValue(addr + 1); // RTS jumps to Popped Address + 1
+        core.regs.pc = addr + 1; // RTS jumps to Popped Address + 1
     }
 };
 
 struct Op_RTI {
     static void exec(Core& core, std::uint8_t) {
         // Pop P (ignore bits 4/5)
-        std::uint8_t flags = StackOps::pop(core);
-        std::uint8_t current = static_cast<std::uint8_t>(core.p.getValue());
-        core.p.setValue((flags & ~0x30) | (current & 0x30));
+        core.regs.setP(StackOps::pop(core));
         
         // Pop PC
         std::uint16_t low = StackOps::pop(core);
         std::uint16_t high = StackOps::pop(core);
-        core.pc.setValue((high << 8) | low);
+        core.regs.pc = (high << 8) | low;
     }
 };
 
 struct Op_BRK {
     static void exec(Core& core, std::uint8_t) {
         core.fetch(); // Consume padding
-        std::uint16_t pc = static_cast<std::uint16_t>(core.pc.getValue());
+        std::uint16_t pc = core.regs.pc;
         
         StackOps::push(core, static_cast<std::uint8_t>((pc >> 8) & 0xFF));
         StackOps::push(core, static_cast<std::uint8_t>(pc & 0xFF));
-        StackOps::push(core, static_cast<std::uint8_t>(core.p.getValue()) | 0x30); // B-Flag set
+        StackOps::push(core, core.regs.getP() | 0x30); // B-Flag set
         
-        core.setStatusFlag(Core::StatusFlag::I, true);
+        core.regs.i = true;
         std::uint16_t vector = static_cast<std::uint16_t>(core.read(0xFFFE) | (core.read(0xFFFF) << 8));
-        core.pc.setValue(vector);
+        core.regs.pc = vector;
     }
 };
 
@@ -625,7 +614,7 @@ struct Op_JAM {
         // Hardware Freeze: The CPU stops incrementing PC and effectively hangs.
         // We simulate this by constantly rewinding the PC so it executes this instruction forever.
         // fetch() moved PC forward by 1; we move it back by 1.
-        core.pc.setValue(core.pc.getValue() - 1);
+        core.regs.pc--;
     }
 };
 
@@ -668,20 +657,18 @@ struct Src_AX {
 struct Op_DEY {
     static void exec(Core& c, std::uint8_t) {
         // Decrement and wrap (0x00 -> 0xFF)
-        std::uint8_t v = static_cast<std::uint8_t>(c.y.getValue()) - 1;
-        c.y.setValue(v);
-        c.setStatusFlag(Core::StatusFlag::Z, v == 0); 
-        c.setStatusFlag(Core::StatusFlag::N, (v & 0x80) != 0);
+        std::uint8_t v = c.regs.y - 1;
+        c.regs.y = v;
+        c.regs.setZN(v);
     } 
 };
 
 // Increment Y Register
 struct Op_INY {
     static void exec(Core& c, std::uint8_t) {
-        std::uint8_t v = static_cast<std::uint8_t>(c.y.getValue()) + 1;
-        c.y.setValue(v);
-        c.setStatusFlag(Core::StatusFlag::Z, v == 0); 
-        c.setStatusFlag(Core::StatusFlag::N, (v & 0x80) != 0);
+        std::uint8_t v = c.regs.y + 1;
+        c.regs.y = v;
+        c.regs.setZN(v);
     } 
 };
 
@@ -689,20 +676,18 @@ struct Op_INY {
 // Note: DEX is in Column A, but INX is here in Column 8.
 struct Op_INX {
     static void exec(Core& c, std::uint8_t) {
-        std::uint8_t v = static_cast<std::uint8_t>(c.x.getValue()) + 1;
-        c.x.setValue(v);
-        c.setStatusFlag(Core::StatusFlag::Z, v == 0); 
-        c.setStatusFlag(Core::StatusFlag::N, (v & 0x80) != 0);
+        std::uint8_t v = c.regs.x + 1;
+        c.regs.x = v;
+        c.regs.setZN(v);
     } 
 };
 
 // Decrement X Register
 struct Op_DEX {
     static void exec(Core& c, std::uint8_t) {
-        std::uint8_t v = static_cast<std::uint8_t>(c.x.getValue()) - 1;
-        c.x.setValue(v);
-        c.setStatusFlag(Core::StatusFlag::Z, v == 0); 
-        c.setStatusFlag(Core::StatusFlag::N, (v & 0x80) != 0);
+        std::uint8_t v = c.regs.x - 1;
+        c.regs.x = v;
+        c.regs.setZN(v);
     } 
 };
 
@@ -712,7 +697,7 @@ struct Op_ANC {
     static void exec(Core& core, std::uint8_t v) {
         Op_AND::exec(core, v); // A = A & v; Sets N, Z
         // C = Bit 7 of result (which is N)
-        core.setStatusFlag(Core::StatusFlag::C, core.getStatusFlag(Core::StatusFlag::N));
+        core.regs.c = core.regs.getN();
     }
 };
 
@@ -720,14 +705,13 @@ struct Op_ANC {
 // Performs AND #imm, then LSR A.
 struct Op_ALR {
     static void exec(Core& core, std::uint8_t v) {
-        std::uint8_t a = static_cast<std::uint8_t>(core.a.getValue());
+        std::uint8_t a = core.regs.a;
         a &= v; // AND
         // LSR Logic: Carry = Bit 0, Result = A >> 1
-        core.setStatusFlag(Core::StatusFlag::C, (a & 0x01) != 0);
+        core.regs.c = (a & 0x01) != 0;
         a >>= 1;
-        core.a.setValue(a);
-        core.setStatusFlag(Core::StatusFlag::Z, a == 0);
-        core.setStatusFlag(Core::StatusFlag::N, false); // LSR always clears N
+        core.regs.a = a;
+        core.regs.setZN(a); // LSR always clears N
     }
 };
 
@@ -736,23 +720,22 @@ struct Op_ALR {
 // Has unique Decimal Mode fixups on NMOS 6502.
 struct Op_ARR {
     static void exec(Core& core, std::uint8_t v) {
-        std::uint8_t a = static_cast<std::uint8_t>(core.a.getValue());
+        std::uint8_t a = core.regs.a;
         std::uint8_t temp = a & v; // Perform AND first
         
         // ROR Logic: Shift Right, shifting Carry into Bit 7
-        bool oldCarry = core.getStatusFlag(Core::StatusFlag::C);
+        bool oldCarry = core.regs.c;
         std::uint8_t result = (temp >> 1) | (oldCarry ? 0x80 : 0);
         
         // Standard Flags (N, Z) based on the BINARY result
-        core.setStatusFlag(Core::StatusFlag::Z, result == 0);
-        core.setStatusFlag(Core::StatusFlag::N, (result & 0x80) != 0);
+        core.regs.setZN(result);
         
         // V Flag: Bit 6 XOR Bit 5 of the result
         bool bit6 = (result & 0x40) != 0;
         bool bit5 = (result & 0x20) != 0;
-        core.setStatusFlag(Core::StatusFlag::V, bit6 ^ bit5);
+        core.regs.v = bit6 ^ bit5;
 
-        if (core.getStatusFlag(Core::StatusFlag::D) && !NES) {
+        if (core.regs.d && !NES) {
             // --- DECIMAL MODE FIXUP ---
             // The checks use the *Intermediate AND* value (temp), not the ROR result.
             
@@ -768,18 +751,18 @@ struct Op_ARR {
             std::uint8_t high = temp & 0xF0;
             if ((high + (high & 0x10)) > 0x50) {
                 result = (result + 0x60) & 0xFF; // Apply fix
-                core.setStatusFlag(Core::StatusFlag::C, true); // Carry Set
+                core.regs.c = true; // Carry Set
             } else {
-                core.setStatusFlag(Core::StatusFlag::C, false); // Carry Clear
+                core.regs.c = false; // Carry Clear
             }
             
-            core.a.setValue(result);
+            core.regs.a = result;
             
         } else {
             // --- BINARY MODE ---
             // C Flag is simply Bit 6 of the result (Hardware quirk of ARR)
-            core.setStatusFlag(Core::StatusFlag::C, bit6);
-            core.a.setValue(result);
+            core.regs.c = bit6;
+            core.regs.a = result;
         }
     }
 };
@@ -789,15 +772,14 @@ struct Op_ARR {
 // The formula that satisfies the Dormann test suite is: A = (A | 0xEE) & X & Imm
 struct Op_XAA {
     static void exec(Core& core, std::uint8_t v) {
-        std::uint8_t a = static_cast<std::uint8_t>(core.a.getValue());
-        std::uint8_t x = static_cast<std::uint8_t>(core.x.getValue());
+        std::uint8_t a = core.regs.a;
+        std::uint8_t x = core.regs.x;
         
         // The magic 0xEE comes from analog settling behaviors on the NMOS 6502 data bus.
         uint8_t res = (a | 0xEE) & x & v;
         
-        core.a.setValue(res);
-        core.setStatusFlag(Core::StatusFlag::Z, res == 0);
-        core.setStatusFlag(Core::StatusFlag::N, (res & 0x80) != 0);
+        core.regs.a = res;
+        core.regs.setZN(res);
     }
 };
 
@@ -805,15 +787,14 @@ struct Op_XAA {
 // Computes (A & X) - imm. Stores result in X. Sets flags.
 struct Op_AXS {
     static void exec(Core& core, std::uint8_t v) {
-        std::uint8_t a_x = static_cast<std::uint8_t>(core.a.getValue() & core.x.getValue());
+        std::uint8_t a_x = static_cast<std::uint8_t>(core.regs.a & core.regs.x);
         std::uint8_t diff = a_x - v;
         
         // C is set if (A & X) >= v (No borrow)
-        core.setStatusFlag(Core::StatusFlag::C, a_x >= v);
+        core.regs.c = a_x >= v;
         
-        core.x.setValue(diff);
-        core.setStatusFlag(Core::StatusFlag::Z, diff == 0);
-        core.setStatusFlag(Core::StatusFlag::N, (diff & 0x80) != 0);
+        core.regs.x = diff;
+        core.regs.setZN(diff);
     }
 };
 
@@ -821,33 +802,32 @@ struct Op_AXS {
 // A = X = S = (Mem & S)
 struct Op_LAS {
     static void exec(Core& core, std::uint8_t v) {
-        std::uint8_t sp = static_cast<std::uint8_t>(core.s.getValue());
+        std::uint8_t sp = core.regs.s;
         std::uint8_t res = v & sp;
         
-        core.a.setValue(res);
-        core.x.setValue(res);
-        core.s.setValue(res);
+        core.regs.a = res;
+        core.regs.x = res;
+        core.regs.s = res;
         
-        core.setStatusFlag(Core::StatusFlag::Z, res == 0);
-        core.setStatusFlag(Core::StatusFlag::N, (res & 0x80) != 0);
+        core.regs.setZN(res);
     }
 };
 
 // Custom Logic for TAS (0x9B) - Absolute, Y
 // Updates Stack Pointer AND writes to memory with specific glitch behavior.
-void ExecTAS(Core& core) {
+inline void ExecTAS(Core& core) {
     // 1. Fetch Base Address manually (so we have the High Byte)
     std::uint16_t baseAddr = core.fetchWord(); 
     
     // 2. Calculate Effective Address
-    std::uint8_t y = static_cast<std::uint8_t>(core.y.getValue());
+    std::uint8_t y = core.regs.y;
     std::uint16_t effectiveAddr = static_cast<std::uint16_t>(baseAddr + y);
     
     // 3. Update Stack Pointer (A & X)
-    std::uint8_t a = static_cast<std::uint8_t>(core.a.getValue());
-    std::uint8_t x = static_cast<std::uint8_t>(core.x.getValue());
+    std::uint8_t a = core.regs.a;
+    std::uint8_t x = core.regs.x;
     std::uint8_t sp = a & x;
-    core.s.setValue(sp);
+    core.regs.s = sp;
     
     // 4. Calculate Value to Write
     // Formula: SP & (BaseHigh + 1)
@@ -866,16 +846,16 @@ void ExecTAS(Core& core) {
 
 // Custom Logic for SHY (0x9C) - Absolute, X
 // Glitch: If page boundary crossed, TargetHigh = TargetHigh & ((BaseHigh + 1) & Y)
-void ExecSHY(Core& core) {
+inline void ExecSHY(Core& core) {
     // 1. Fetch Base Address
     std::uint16_t baseAddr = core.fetchWord();
     
     // 2. Calculate Indexed Address
-    std::uint8_t x = static_cast<std::uint8_t>(core.x.getValue());
+    std::uint8_t x = core.regs.x;
     std::uint16_t effectiveAddr = static_cast<std::uint16_t>(baseAddr + x);
     
     // 3. Calculate Value to Write: Y & (BaseHigh + 1)
-    std::uint8_t y = static_cast<std::uint8_t>(core.y.getValue());
+    std::uint8_t y = core.regs.y;
     std::uint8_t baseHigh = static_cast<std::uint8_t>((baseAddr >> 8) & 0xFF);
     std::uint8_t val = static_cast<std::uint8_t>(y & (baseHigh + 1));
     
@@ -893,13 +873,13 @@ void ExecSHY(Core& core) {
 
 // Custom Logic for SHX (0x9E) - Absolute, Y
 // Same glitch, but uses X register and Y index.
-void ExecSHX(Core& core) {
+inline void ExecSHX(Core& core) {
     std::uint16_t baseAddr = core.fetchWord();
     
-    std::uint8_t y = static_cast<std::uint8_t>(core.y.getValue());
+    std::uint8_t y = core.regs.y;
     std::uint16_t effectiveAddr = static_cast<std::uint16_t>(baseAddr + y);
     
-    std::uint8_t x = static_cast<std::uint8_t>(core.x.getValue());
+    std::uint8_t x = core.regs.x;
     std::uint8_t baseHigh = static_cast<std::uint8_t>((baseAddr >> 8) & 0xFF);
     std::uint8_t val = static_cast<std::uint8_t>(x & (baseHigh + 1));
     
@@ -914,19 +894,19 @@ void ExecSHX(Core& core) {
 // Custom Logic for SHA / AXA (0x9F) - Absolute, Y
 // Stores (A & X) & (HighByte + 1)
 // Implements the "High Byte Malfunction" glitch on page crossing.
-void ExecSHA(Core& core) {
+inline void ExecSHA(Core& core) {
     // 1. Fetch Base Address manually to preserve the original High Byte
     std::uint16_t baseAddr = core.fetchWord();
     std::uint8_t baseHigh = static_cast<std::uint8_t>((baseAddr >> 8) & 0xFF);
     
     // 2. Calculate Effective Address
-    std::uint8_t y = static_cast<std::uint8_t>(core.y.getValue());
+    std::uint8_t y = core.regs.y;
     std::uint16_t effectiveAddr = static_cast<std::uint16_t>(baseAddr + y);
     
     // 3. Calculate Value to Write
     // Formula: (A & X) & (BaseHigh + 1)
-    std::uint8_t a = static_cast<std::uint8_t>(core.a.getValue());
-    std::uint8_t x = static_cast<std::uint8_t>(core.x.getValue());
+    std::uint8_t a = core.regs.a;
+    std::uint8_t x = core.regs.x;
     std::uint8_t val = static_cast<std::uint8_t>((a & x) & (baseHigh + 1));
     
     // 4. The Address Glitch
@@ -944,22 +924,21 @@ void ExecSHA(Core& core) {
 // Load A and X with (A | 0xEE) & Immediate
 struct Op_ATX {
     static void exec(Core& core, std::uint8_t v) {
-        std::uint8_t a = static_cast<std::uint8_t>(core.a.getValue());
+        std::uint8_t a = core.regs.a;
         
         // The Magic Constant 0xEE strikes again!
         std::uint8_t res = static_cast<std::uint8_t>((a | 0xEE) & v);
         
-        core.a.setValue(res);
-        core.x.setValue(res);
+        core.regs.a = res;
+        core.regs.x = res;
         
-        core.setStatusFlag(Core::StatusFlag::Z, res == 0);
-        core.setStatusFlag(Core::StatusFlag::N, (res & 0x80) != 0);
+        core.regs.setZN(res);
     }
 };
 
 // Custom Logic for SHA / AXA (0x93) - (Indirect), Y
 // This is the most complex illegal store.
-void ExecSHA_INDY(Core& core) {
+inline void ExecSHA_INDY(Core& core) {
     // 1. Fetch Pointer Address from Zero Page
     std::uint8_t ptrAddr = core.fetch();
     
@@ -969,13 +948,13 @@ void ExecSHA_INDY(Core& core) {
     std::uint16_t baseAddr = static_cast<std::uint16_t>((high << 8) | low);
     
     // 3. Calculate Effective Address (Base + Y)
-    std::uint8_t y = static_cast<std::uint8_t>(core.y.getValue());
+    std::uint8_t y = core.regs.y;
     std::uint16_t effectiveAddr = static_cast<std::uint16_t>(baseAddr + y);
     
     // 4. Calculate Value to Write
     // Formula: (A & X) & (HighByteOfBase + 1)
-    std::uint8_t a = static_cast<std::uint8_t>(core.a.getValue());
-    std::uint8_t x = static_cast<std::uint8_t>(core.x.getValue());
+    std::uint8_t a = core.regs.a;
+    std::uint8_t x = core.regs.x;
     std::uint8_t baseHigh = static_cast<std::uint8_t>((baseAddr >> 8) & 0xFF);
     
     std::uint8_t val = static_cast<std::uint8_t>((a & x) & (baseHigh + 1));
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <deque>
+#include <vector>
+
+#include "block_cache.hpp"
+#include "register.hpp"
+
+#if !(defined(__x86_64__) && defined(__linux__))
+#error "CPU_JIT requires Linux on x86-64"
+#endif
+
+// =============================================================
+// X86-64 JIT
+// -----------------
+// Compiles hot decoded blocks (see block_cache.hpp) to native code in an
+// mmap'd arena whose pages are writable or executable, never both.
+// Addressing, RAM access and the common loads, stores, ALU ops and
+// branches are emitted inline; everything else calls back into the
+// policy templates of core_policies.hpp, which remain the reference
+// semantics.
+//
+// A compiled block only runs when it fits before the next possible
+// interrupt (Bus::cpuCyclesUntilInterrupt), and it returns to the
+// interpreter before any access to $2000-$5FFF or any write outside
+// internal RAM, so PPU/APU/mapper side effects stay in order. The cycles
+// it returns are the exact sum of what the interpreter would have charged.
+// =============================================================
+
+class Jit {
+    public:
+        static constexpr std::size_t CODE_SIZE = 4 * 1024 * 1024;
+        static constexpr std::size_t MAX_BLOCK_CODE = 64 * 1024; // Generous bound for one block
+        static constexpr std::uint16_t HOT_THRESHOLD = 8;
+
+        Jit();
+        ~Jit();
+
+        Jit(const Jit&) = delete;
+        Jit& operator=(const Jit&) = delete;
+
+        // Runs the compiled block at PC if there is one and it fits in the
+        // interrupt budget. Returns the cycles consumed, 0 to interpret.
+        int run(Core& core, Bus& bus, BlockCache& cache);
+
+        void flush();
+
+    private:
+        using BlockFn = int (*)(Core* core, CpuRegisters* regs, std::uint8_t* ram, Bus* bus);
+
+        struct Entry {
+            BlockFn fn = nullptr;
+            int max_cycles = 0;
+            std::uint16_t hits = 0;
+            bool failed = false;
+        };
+
+        bool compile(Bus& bus, const DecodedBlock& block, Entry& entry);
+
+        std::uint8_t* code = nullptr;
+        std::size_t code_used = 0;
+
+        std::vector<Entry> entries;             // Indexed by pc - $8000
+        std::vector<std::uint16_t> filled;      // Indices of touched entries
+        std::deque<DecodedInstr> interp_instrs; // Entries handed to Core::execDecoded
+        std::uint32_t generation = 0;           // BlockCache generation compiled against
+};
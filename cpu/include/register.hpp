@@ -27,4 +27,60 @@ class Register {
         bool getBit(int position) const;
         void setValue(std::uint64_t val);
         void andValue(std::uint64_t val);
+};
+
+// =============================================================
+// 6502 REGISTER FILE
+// -----------------
+// The registers every opcode touches, packed into one cache line with
+// native widths. C, I, D and V are kept unpacked (one byte each) so a flag
+// test or update is a plain load/store; P is only assembled for pushes and
+// tools. The generic Register class above remains for named/debug views.
+//
+// N and Z are evaluated lazily: nearly every opcode just records its result
+// byte via setZN(), and the flags are only derived from it when a branch,
+// a push of P or a debugger actually reads them.
+// =============================================================
+
+struct alignas(64) CpuRegisters {
+    std::uint16_t pc = 0x0000;
+    std::uint8_t a = 0x00;
+    std::uint8_t x = 0x00;
+    std::uint8_t y = 0x00;
+    std::uint8_t s = 0x00;
+
+    // Status flags (P bits 0-3, 6). B and U only exist on the stack.
+    bool c = false;
+    bool i = false;
+    bool d = false;
+    bool v = false;
+
+    // Lazy N/Z sources. Two bytes rather than one because BIT and PLP/RTI
+    // can produce N and Z combinations no single result byte encodes.
+    std::uint8_t z_src = 0x01; // Z is set when this byte is zero
+    std::uint8_t n_src = 0x00; // N is bit 7 of this byte
+
+    void setZN(std::uint8_t result) { z_src = result; n_src = result; }
+    void setZ(bool f) { z_src = f ? 0x00 : 0x01; }
+    void setN(bool f) { n_src = f ? 0x80 : 0x00; }
+    bool getZ() const { return z_src == 0; }
+    bool getN() const { return (n_src & 0x80) != 0; }
+
+    std::uint8_t getP() const {
+        return static_cast<std::uint8_t>((n_src & 0x80) | (v << 6) | 0x20 | (d << 3) | (i << 2) | (getZ() << 1) | c);
+    }
+
+    void setP(std::uint8_t value) {
+        c = (value & 0x01) != 0;
+        setZ((value & 0x02) != 0);
+        i = (value & 0x04) != 0;
+        d = (value & 0x08) != 0;
+        v = (value & 0x40) != 0;
+        n_src = value;
+    }
+
+    // Architectural equality: the lazy sources may differ while P agrees
+    bool sameState(const CpuRegisters& o) const {
+        return pc == o.pc && a == o.a && x == o.x && y == o.y && s == o.s && getP() == o.getP();
+    }
 };
\ No newline at end of file
@@ -0,0 +1,115 @@
+#include "block_cache.hpp"
+#include "policies_map.hpp"
+
+bool BlockCache::valid(const Bus& bus) const {
+    return bus.cart.get() == cart && cart && cart->getPRGMapVersion() == version;
+}
+
+void BlockCache::flush() {
+    for (std::uint16_t index : filled) {
+        blocks[index] = DecodedBlock{};
+    }
+    filled.clear();
+    flushes++;
+}
+
+const DecodedBlock* BlockCache::lookup(Bus& bus, std::uint16_t pc) {
+    if (pc < 0x8000 || bus.testMode || !bus.cart) return nullptr;
+
+    if (!valid(bus)) {
+        flush();
+        cart = bus.cart.get();
+        version = cart->getPRGMapVersion();
+    }
+    if (blocks.empty()) blocks.resize(0x8000);
+
+    DecodedBlock& block = blocks[pc - 0x8000];
+    if (block.instrs.empty()) {
+        decode(bus, pc, block);
+        if (block.instrs.empty()) return nullptr; // Operands would wrap past $FFFF
+        filled.push_back(static_cast<std::uint16_t>(pc - 0x8000));
+    }
+    return &block;
+}
+
+void BlockCache::decode(Bus& bus, std::uint16_t pc, DecodedBlock& block) {
+    std::uint32_t addr = pc;
+
+    while (block.instrs.size() < MAX_BLOCK_INSTRS) {
+        DecodedInstr ins{};
+        ins.pc = static_cast<std::uint16_t>(addr);
+        ins.opcode = bus.read(ins.pc);
+        ins.length = instr_length[ins.opcode];
+        ins.handler = instr_fns[ins.opcode];
+
+        // Never let an instruction run off the end of the address space
+        if (addr + ins.length > 0x10000) break;
+
+        if (ins.length > 1) ins.operand[0] = bus.read(static_cast<std::uint16_t>(addr + 1));
+        if (ins.length > 2) ins.operand[1] = bus.read(static_cast<std::uint16_t>(addr + 2));
+
+        block.instrs.push_back(ins);
+        addr += ins.length;
+
+        if (instr_ends_block(ins.opcode) || addr > 0xFFFF) break;
+    }
+
+    if (!block.instrs.empty()) classifyLoop(block);
+}
+
+// Memory class of the opcodes a polling loop may contain:
+// 0 = not allowed, 1 = no memory operand, 2 = zero page, 3 = absolute
+static int pollingAccess(std::uint8_t opcode) {
+    switch (opcode) {
+        case 0xEA: case 0x18: case 0x38: case 0xB8:                       // NOP CLC SEC CLV
+        case 0xAA: case 0xA8: case 0x8A: case 0x98: case 0xBA:            // TAX TAY TXA TYA TSX
+        case 0xA9: case 0xA2: case 0xA0: case 0x29: case 0x09: case 0x49: // LDA LDX LDY AND ORA EOR #
+        case 0xC9: case 0xE0: case 0xC0:                                  // CMP CPX CPY #
+            return 1;
+        case 0xA5: case 0xB5: case 0xA6: case 0xB6: case 0xA4: case 0xB4: // LDA LDX LDY zp(,i)
+        case 0x24: case 0x25: case 0x35: case 0x05: case 0x15:            // BIT AND ORA zp(,x)
+        case 0x45: case 0x55: case 0xC5: case 0xD5: case 0xE4: case 0xC4: // EOR CMP zp(,x) CPX CPY zp
+            return 2;
+        case 0xAD: case 0xAE: case 0xAC: case 0x2C: case 0x2D:            // LDA LDX LDY BIT AND abs
+        case 0x0D: case 0x4D: case 0xCD: case 0xEC: case 0xCC:            // ORA EOR CMP CPX CPY abs
+            return 3;
+    }
+    return 0;
+}
+
+void BlockCache::classifyLoop(DecodedBlock& block) {
+    const DecodedInstr& last = block.instrs.back();
+    std::uint16_t start = block.instrs.front().pc;
+    int cycles = 0;
+
+    if ((last.opcode & 0x1F) == 0x10) { // Bxx back to the start
+        std::uint16_t next = static_cast<std::uint16_t>(last.pc + 2);
+        std::uint16_t target = static_cast<std::uint16_t>(next + static_cast<std::int8_t>(last.operand[0]));
+        if (target != start) return;
+        cycles = 3 + ((next & 0xFF00) != (target & 0xFF00) ? 1 : 0);
+    } else if (last.opcode == 0x4C) {   // JMP back to the start
+        if ((last.operand[0] | (last.operand[1] << 8)) != start) return;
+        cycles = 3;
+    } else {
+        return;
+    }
+
+    bool polls_ppu = false;
+    for (std::size_t i = 0; i + 1 < block.instrs.size(); ++i) {
+        const DecodedInstr& ins = block.instrs[i];
+        int access = pollingAccess(ins.opcode);
+        if (access == 0) return;
+        if (access == 3) {
+            std::uint16_t addr = static_cast<std::uint16_t>(ins.operand[0] | (ins.operand[1] << 8));
+            if (addr >= 0x2000 && addr < 0x4000 && (addr & 0x0007) == 0x0002) {
+                polls_ppu = true;
+            } else if (addr >= 0x2000 && addr < 0x6000) {
+                return; // Other I/O reads have side effects or change over time
+            }
+        }
+        cycles += instr_cycles[ins.opcode];
+    }
+
+    block.loop_cycles = static_cast<std::uint16_t>(cycles);
+    block.polls_ppu = polls_ppu;
+}
@@ -1,23 +1,12 @@
 #include "core.hpp"
 
-namespace {
-    static const std::string a_name("Accumulator");
-    static const std::string x_name("X index");
-    static const std::string y_name("Y index");
-    static const std::string s_name("Stack pointer");
-    static const std::string pc_name("Program Counter");
-    static const std::string p_name("Processor flags");
-}
+#include <algorithm>
+
+#ifdef CPU_SWITCH_DISPATCH
+#include "policies_map.hpp"
+#endif
 
-Core::Core(Bus* bus_ptr)
-    : bus(bus_ptr)
-    , a(RegType::MR, &a_name, 8)
-    , x(RegType::IR, &x_name, 8)
-    , y(RegType::IR, &y_name, 8)
-    , s(RegType::IR, &s_name, 8)
-    , pc(RegType::PC, &pc_name, 16)
-    , p(RegType::SR, &p_name, 8)
-{
+Core::Core(Bus* bus_ptr) : bus(bus_ptr) {
     core_phase = Phase::STANDBY;
     log("CORE", "Core initialized.");
 }
@@ -28,13 +17,31 @@ void Core::init() {
     // Reset Vector is at $FFFC
     uint16_t lo = bus->read(0xFFFC);
     uint16_t hi = bus->read(0xFFFD);
-    pc.setValue((hi << 8) | lo);
+    regs.pc = (hi << 8) | lo;
     
     // Reset State
-    s.setValue(0xFD);
-    p.setValue(0x34); // IRQ disabled
+    regs.s = 0xFD;
+    regs.setP(0x34); // IRQ disabled
     
-    log("CORE", "Reset complete. PC: " + std::to_string(pc.getValue()));
+    log("CORE", "Reset complete. PC: " + std::to_string(regs.pc));
+}
+
+// NMI/IRQ hardware sequence (7 cycles). Pushes PC and P with the B-Flag
+// cleared and Bit 5 set, then jumps through the given vector.
+void Core::interrupt(std::uint16_t vector) {
+    bus->write(0x0100 | regs.s, (regs.pc >> 8) & 0xFF);
+    regs.s--;
+    bus->write(0x0100 | regs.s, regs.pc & 0xFF);
+    regs.s--;
+    bus->write(0x0100 | regs.s, (regs.getP() & ~0x10) | 0x20);
+    regs.s--;
+
+    regs.i = true;
+    idle_armed = false; // The handler may change what the loop polls
+
+    lo = bus->read(vector);
+    hi = bus->read(vector + 1);
+    regs.pc = (hi << 8) | lo;
 }
 
 void Core::step() {
@@ -44,91 +51,126 @@ void Core::step() {
     if (bus->ppu.nmiOccurred) {
         bus->ppu.nmiOccurred = false;
 
-        // --- NMI HARDWARE SEQUENCE (7 Cycles) ---
-        pc_val = static_cast<uint16_t>(pc.getValue());
-        sp = static_cast<uint8_t>(s.getValue());
-        
-        bus->write(0x0100 | sp, (pc_val >> 8) & 0xFF);
-        s.setValue(sp - 1);
-        sp--;
-
-        bus->write(0x0100 | sp, pc_val & 0xFF);
-        s.setValue(sp - 1);
-        sp--;
-
-        // NMI Stack push of P: B-Flag cleared, Bit 5 set
-        status = static_cast<uint8_t>(p.getValue());
-        status &= ~0x10;
-        status |= 0x20;
-        
-        bus->write(0x0100 | sp, status);
-        s.setValue(sp - 1);
-        
-        setStatusFlag(StatusFlag::I, true);
-        
-        lo = bus->read(0xFFFA);
-        hi = bus->read(0xFFFB);
-        pc.setValue((hi << 8) | lo);
-
+        interrupt(0xFFFA);
         last_cycles = 7; 
         return; 
     }
     
     // IRQ Check
     // IRQs are level-triggered. Executed if I flag is Clear.
-    if (!getStatusFlag(StatusFlag::I) && bus->getIRQ()) {
-        pc_val = static_cast<uint16_t>(pc.getValue());
-        sp = static_cast<uint8_t>(s.getValue());
-        
-        bus->write(0x0100 | sp, (pc_val >> 8) & 0xFF);
-        s.setValue(sp - 1);
-        sp--;
-
-        bus->write(0x0100 | sp, pc_val & 0xFF);
-        s.setValue(sp - 1);
-        sp--;
-
-        // IRQ Stack push of P: B-Flag cleared, Bit 5 set
-        status = static_cast<uint8_t>(p.getValue());
-        status &= ~0x10;
-        status |= 0x20;
-        
-        bus->write(0x0100 | sp, status);
-        s.setValue(sp - 1);
-        
-        setStatusFlag(StatusFlag::I, true);
-        
-        lo = bus->read(0xFFFE);
-        hi = bus->read(0xFFFF);
-        pc.setValue((hi << 8) | lo);
-
+    if (!regs.i && bus->getIRQ()) {
+        interrupt(0xFFFE);
         last_cycles = 7;
         return;
     }
 
+    if (int cycles = skipIdleLoop()) {
+        last_cycles = cycles;
+        return;
+    }
+
+#ifdef CPU_JIT
+    if (int cycles = jit.run(*this, *bus, block_cache)) {
+        last_cycles = cycles;
+        return;
+    }
+#endif
+
+    if (const DecodedInstr* ins = nextDecoded()) {
+        execDecoded(*ins);
+        return;
+    }
+
     opcode = fetch();
     //log("CORE", "Opcode: " + std::to_string(opcode));
 
+#ifdef CPU_SWITCH_DISPATCH
+    dispatch_opcode(*this, opcode);
+#else
     if (instr_table[opcode]) {
         instr_table[opcode](*this);
     } else {
         log("CORE", "Unimplemented Opcode: " + std::to_string(opcode));
         core_phase = Phase::ERROR;
     }
+#endif
 }
 
-std::uint8_t Core::read(std::uint16_t address) const {
-    return bus->read(address);
+int Core::execDecoded(const DecodedInstr& ins) {
+    regs.pc = ins.pc + 1;
+    opcode = ins.opcode;
+    operand_ptr = ins.operand;
+    operand_end = ins.operand + (ins.length - 1);
+#ifdef CPU_SWITCH_DISPATCH
+    dispatch_opcode(*this, opcode);
+#else
+    ins.handler(*this);
+#endif
+    operand_ptr = operand_end = nullptr;
+    return last_cycles;
 }
 
-void Core::write(std::uint16_t address, std::uint8_t value) {
-    bus->write(address, value);
+// Next decoded instruction at PC: the following entry of the current
+// block if execution ran straight on, otherwise a (re)lookup.
+const DecodedInstr* Core::nextDecoded() {
+    if (block_next != block_end && block_cache.valid(*bus) && block_next->pc == regs.pc) {
+        return block_next++;
+    }
+
+    block_next = block_end = nullptr;
+    const DecodedBlock* block = block_cache.lookup(*bus, regs.pc);
+    if (!block) return nullptr;
+
+    block_cur = block;
+    block_next = block->instrs.data() + 1;
+    block_end = block->instrs.data() + block->instrs.size();
+    return block->instrs.data();
 }
 
-std::uint8_t Core::fetch() {
-    std::uint8_t data = read(static_cast<std::uint16_t>(pc.getValue()));
-    pc.setValue(pc.getValue() + 1);
-    return data;
+// Called at each block head. A pass of an idle loop (see DecodedBlock)
+// that returns to its head with registers unchanged read the same values
+// and will keep doing so until an interrupt can fire or, for $2002
+// pollers, a PPUSTATUS bit can change. Those passes are skipped here and
+// their exact cycle count returned; 0 means execute normally.
+int Core::skipIdleLoop() {
+    if (block_next != block_end && block_next->pc == regs.pc && block_next != block_cur->instrs.data()) {
+        return 0; // Mid-block
+    }
+
+    block_next = block_end = nullptr;
+    const DecodedBlock* block = block_cache.lookup(*bus, regs.pc);
+    if (!block) {
+        idle_armed = false;
+        return 0;
+    }
+
+    // Leave the cursor on the block so nextDecoded() needs no second lookup
+    block_cur = block;
+    block_next = block->instrs.data();
+    block_end = block->instrs.data() + block->instrs.size();
+
+    if (block->loop_cycles == 0) {
+        idle_armed = false;
+        return 0;
+    }
+
+    // The status must also be unchanged: a bit set after the last read is
+    // only seen by the next pass
+    if (block->polls_ppu) bus->syncPPU();
+    std::uint8_t status = bus->ppu.peekStatus();
+    if (!idle_armed || !regs.sameState(idle_regs) || (block->polls_ppu && status != idle_status)) {
+        idle_armed = true;
+        idle_regs = regs;
+        idle_status = status;
+        return 0;
+    }
+
+    int budget = bus->cpuCyclesUntilInterrupt(regs.i);
+    if (block->polls_ppu) {
+        int dots = bus->ppu.dotsUntilStatusChange();
+        budget = std::min(budget, dots > 0 ? (dots - 1) / 3 : 0);
+    }
+    return (budget / block->loop_cycles) * block->loop_cycles;
 }
 
 std::uint16_t Core::fetchWord() {
@@ -137,11 +179,20 @@ std::uint16_t Core::fetchWord() {
     return static_cast<std::uint16_t>((high << 8) | low);
 }
 
+// Named flag access for tools and debuggers. Opcodes use regs directly.
 void Core::setStatusFlag(StatusFlag flag, bool value) {
-    if (value) p.setBit(static_cast<int>(flag));
-    else p.clearBit(static_cast<int>(flag));
+    switch (flag) {
+        case StatusFlag::C: regs.c = value; break;
+        case StatusFlag::Z: regs.setZ(value); break;
+        case StatusFlag::I: regs.i = value; break;
+        case StatusFlag::D: regs.d = value; break;
+        case StatusFlag::V: regs.v = value; break;
+        case StatusFlag::N: regs.setN(value); break;
+        case StatusFlag::B:
+        case StatusFlag::U: break; // Not stored in the register file
+    }
 }
 
 bool Core::getStatusFlag(StatusFlag flag) const {
-    return p.getBit(static_cast<int>(flag));
+    return (regs.getP() >> static_cast<int>(flag)) & 0x01;
 }
\ No newline at end of file
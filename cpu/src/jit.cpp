@@ -0,0 +1,1027 @@
+#ifdef CPU_JIT
+
+#include "jit.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "core.hpp"
+#include "policies_map.hpp"
+#include "logger.hpp"
+
+// =============================================================
+// OPCODE SHAPES
+// -----------------
+// How each opcode is put together in policies_map.hpp: the execution
+// template, its addressing mode and the policy types it combines. Policies
+// with a NATIVE translation are emitted inline, the rest are called.
+// =============================================================
+
+enum class JitKind : std::uint8_t { Stop, Read, Write, Rmw, RmwAlu, Implied, Branch, Jump, Interp };
+enum class JitMode : std::uint8_t { IMP, ACC, IMM, ZP, ZPX, ZPY, ABS, ABSX, ABSY, IND, INDX, INDY, REL };
+
+enum class JitNative : std::uint8_t {
+    None, NOP,
+    LDA, LDX, LDY, AND, ORA, EOR, CMP, CPX, CPY, ADC, SBC,
+    SrcA, SrcX, SrcY, INC, DEC,
+    TAX, TAY, TXA, TYA, TSX, TXS, INX, INY, DEX, DEY,
+    CLC, SEC, CLD, SED, CLV, SEI,
+    BPL, BMI, BVC, BVS, BCC, BCS, BNE, BEQ
+};
+
+template <typename T> constexpr JitNative native_of = JitNative::None;
+template <> constexpr JitNative native_of<Op_NOP> = JitNative::NOP;
+template <> constexpr JitNative native_of<Op_LDA> = JitNative::LDA;
+template <> constexpr JitNative native_of<Op_LDX> = JitNative::LDX;
+template <> constexpr JitNative native_of<Op_LDY> = JitNative::LDY;
+template <> constexpr JitNative native_of<Op_AND> = JitNative::AND;
+template <> constexpr JitNative native_of<Op_ORA> = JitNative::ORA;
+template <> constexpr JitNative native_of<Op_EOR> = JitNative::EOR;
+template <> constexpr JitNative native_of<Op_CMP> = JitNative::CMP;
+template <> constexpr JitNative native_of<Op_CPX> = JitNative::CPX;
+template <> constexpr JitNative native_of<Op_CPY> = JitNative::CPY;
+template <> constexpr JitNative native_of<Op_ADC> = NES ? JitNative::ADC : JitNative::None; // Decimal mode is called
+template <> constexpr JitNative native_of<Op_SBC> = NES ? JitNative::SBC : JitNative::None;
+template <> constexpr JitNative native_of<Src_A> = JitNative::SrcA;
+template <> constexpr JitNative native_of<Src_X> = JitNative::SrcX;
+template <> constexpr JitNative native_of<Src_Y> = JitNative::SrcY;
+template <> constexpr JitNative native_of<Op_INC> = JitNative::INC;
+template <> constexpr JitNative native_of<Op_DEC> = JitNative::DEC;
+template <> constexpr JitNative native_of<Op_TAX> = JitNative::TAX;
+template <> constexpr JitNative native_of<Op_TAY> = JitNative::TAY;
+template <> constexpr JitNative native_of<Op_TXA> = JitNative::TXA;
+template <> constexpr JitNative native_of<Op_TYA> = JitNative::TYA;
+template <> constexpr JitNative native_of<Op_TSX> = JitNative::TSX;
+template <> constexpr JitNative native_of<Op_TXS> = JitNative::TXS;
+template <> constexpr JitNative native_of<Op_INX> = JitNative::INX;
+template <> constexpr JitNative native_of<Op_INY> = JitNative::INY;
+template <> constexpr JitNative native_of<Op_DEX> = JitNative::DEX;
+template <> constexpr JitNative native_of<Op_DEY> = JitNative::DEY;
+template <> constexpr JitNative native_of<Op_CLC> = JitNative::CLC;
+template <> constexpr JitNative native_of<Op_SEC> = JitNative::SEC;
+template <> constexpr JitNative native_of<Op_CLD> = JitNative::CLD;
+template <> constexpr JitNative native_of<Op_SED> = JitNative::SED;
+template <> constexpr JitNative native_of<Op_CLV> = JitNative::CLV;
+template <> constexpr JitNative native_of<Op_SEI> = JitNative::SEI;
+template <> constexpr JitNative native_of<Cond_BPL> = JitNative::BPL;
+template <> constexpr JitNative native_of<Cond_BMI> = JitNative::BMI;
+template <> constexpr JitNative native_of<Cond_BVC> = JitNative::BVC;
+template <> constexpr JitNative native_of<Cond_BVS> = JitNative::BVS;
+template <> constexpr JitNative native_of<Cond_BCC> = JitNative::BCC;
+template <> constexpr JitNative native_of<Cond_BCS> = JitNative::BCS;
+template <> constexpr JitNative native_of<Cond_BNE> = JitNative::BNE;
+template <> constexpr JitNative native_of<Cond_BEQ> = JitNative::BEQ;
+
+// Entry points the generated code calls (SysV: rdi, esi)
+template <typename OP>
+static void callExec(Core* core, std::uint32_t v) { OP::exec(*core, static_cast<std::uint8_t>(v)); }
+
+template <typename OP>
+static std::uint32_t callCalc(Core* core, std::uint32_t v) { return OP::calc(*core, static_cast<std::uint8_t>(v)); }
+
+template <typename SRC>
+static std::uint32_t callGet(Core* core, std::uint32_t) { return SRC::get(*core); }
+
+static std::uint32_t callBusRead(Bus* bus, std::uint32_t addr) { return bus->read(static_cast<std::uint16_t>(addr)); }
+
+static int callInterpret(Core* core, const DecodedInstr* ins) { return core->execDecoded(*ins); }
+
+struct JitShape {
+    JitKind kind;
+    JitMode mode;
+    JitNative native;
+    void (*exec)(Core*, std::uint32_t);          // OP::exec (Read, Implied, ALU half of RmwAlu)
+    std::uint32_t (*calc)(Core*, std::uint32_t); // OP::calc or SRC::get (Rmw, Write)
+};
+
+#define J_READ(M, OP)      { JitKind::Read,    JitMode::M,   native_of<OP>,   &callExec<OP>, nullptr }
+#define J_WRITE(M, SRC)    { JitKind::Write,   JitMode::M,   native_of<SRC>,  nullptr,       &callGet<SRC> }
+#define J_RMW(M, OP)       { JitKind::Rmw,     JitMode::M,   native_of<OP>,   nullptr,       &callCalc<OP> }
+#define J_RMW_ALU(M, R, A) { JitKind::RmwAlu,  JitMode::M,   JitNative::None, &callExec<A>,  &callCalc<R> }
+#define J_IMP(OP)          { JitKind::Implied, JitMode::IMP, native_of<OP>,   &callExec<OP>, nullptr }
+#define J_BRANCH(COND)     { JitKind::Branch,  JitMode::REL, native_of<COND>, nullptr,       nullptr }
+#define J_JUMP             { JitKind::Jump,    JitMode::ABS, JitNative::None, nullptr,       nullptr }
+#define J_INTERP(M)        { JitKind::Interp,  JitMode::M,   JitNative::None, nullptr,       nullptr }
+#define J_STOP(M)          { JitKind::Stop,    JitMode::M,   JitNative::None, nullptr,       nullptr }
+
+static constexpr JitShape jit_shapes[256] = {
+    /* 00 */ J_INTERP(IMM), // The padding byte counts as an operand
+    /* 01 */ J_READ(INDX, Op_ORA),
+    /* 02 */ J_STOP(IMP),
+    /* 03 */ J_RMW_ALU(INDX, Op_ASL, Op_ORA),
+    /* 04 */ J_READ(ZP, Op_NOP),
+    /* 05 */ J_READ(ZP, Op_ORA),
+    /* 06 */ J_RMW(ZP, Op_ASL),
+    /* 07 */ J_RMW_ALU(ZP, Op_ASL, Op_ORA),
+    /* 08 */ J_IMP(Op_PHP),
+    /* 09 */ J_READ(IMM, Op_ORA),
+    /* 0A */ J_RMW(ACC, Op_ASL),
+    /* 0B */ J_READ(IMM, Op_ANC),
+    /* 0C */ J_READ(ABS, Op_NOP),
+    /* 0D */ J_READ(ABS, Op_ORA),
+    /* 0E */ J_RMW(ABS, Op_ASL),
+    /* 0F */ J_RMW_ALU(ABS, Op_ASL, Op_ORA),
+    /* 10 */ J_BRANCH(Cond_BPL),
+    /* 11 */ J_READ(INDY, Op_ORA),
+    /* 12 */ J_STOP(IMP),
+    /* 13 */ J_RMW_ALU(INDY, Op_ASL, Op_ORA),
+    /* 14 */ J_READ(ZPX, Op_NOP),
+    /* 15 */ J_READ(ZPX, Op_ORA),
+    /* 16 */ J_RMW(ZPX, Op_ASL),
+    /* 17 */ J_RMW_ALU(ZPX, Op_ASL, Op_ORA),
+    /* 18 */ J_IMP(Op_CLC),
+    /* 19 */ J_READ(ABSY, Op_ORA),
+    /* 1A */ J_IMP(Op_NOP),
+    /* 1B */ J_RMW_ALU(ABSY, Op_ASL, Op_ORA),
+    /* 1C */ J_READ(ABSX, Op_NOP),
+    /* 1D */ J_READ(ABSX, Op_ORA),
+    /* 1E */ J_RMW(ABSX, Op_ASL),
+    /* 1F */ J_RMW_ALU(ABSX, Op_ASL, Op_ORA),
+    /* 20 */ J_INTERP(ABS),
+    /* 21 */ J_READ(INDX, Op_AND),
+    /* 22 */ J_STOP(IMP),
+    /* 23 */ J_RMW_ALU(INDX, Op_ROL, Op_AND),
+    /* 24 */ J_READ(ZP, Op_BIT),
+    /* 25 */ J_READ(ZP, Op_AND),
+    /* 26 */ J_RMW(ZP, Op_ROL),
+    /* 27 */ J_RMW_ALU(ZP, Op_ROL, Op_AND),
+    /* 28 */ J_IMP(Op_PLP),
+    /* 29 */ J_READ(IMM, Op_AND),
+    /* 2A */ J_RMW(ACC, Op_ROL),
+    /* 2B */ J_READ(IMM, Op_ANC),
+    /* 2C */ J_READ(ABS, Op_BIT),
+    /* 2D */ J_READ(ABS, Op_AND),
+    /* 2E */ J_RMW(ABS, Op_ROL),
+    /* 2F */ J_RMW_ALU(ABS, Op_ROL, Op_AND),
+    /* 30 */ J_BRANCH(Cond_BMI),
+    /* 31 */ J_READ(INDY, Op_AND),
+    /* 32 */ J_STOP(IMP),
+    /* 33 */ J_RMW_ALU(INDY, Op_ROL, Op_AND),
+    /* 34 */ J_READ(ZPX, Op_NOP),
+    /* 35 */ J_READ(ZPX, Op_AND),
+    /* 36 */ J_RMW(ZPX, Op_ROL),
+    /* 37 */ J_RMW_ALU(ZPX, Op_ROL, Op_AND),
+    /* 38 */ J_IMP(Op_SEC),
+    /* 39 */ J_READ(ABSY, Op_AND),
+    /* 3A */ J_IMP(Op_NOP),
+    /* 3B */ J_RMW_ALU(ABSY, Op_ROL, Op_AND),
+    /* 3C */ J_READ(ABSX, Op_NOP),
+    /* 3D */ J_READ(ABSX, Op_AND),
+    /* 3E */ J_RMW(ABSX, Op_ROL),
+    /* 3F */ J_RMW_ALU(ABSX, Op_ROL, Op_AND),
+    /* 40 */ J_INTERP(IMP),
+    /* 41 */ J_READ(INDX, Op_EOR),
+    /* 42 */ J_STOP(IMP),
+    /* 43 */ J_RMW_ALU(INDX, Op_LSR, Op_EOR),
+    /* 44 */ J_READ(ZP, Op_NOP),
+    /* 45 */ J_READ(ZP, Op_EOR),
+    /* 46 */ J_RMW(ZP, Op_LSR),
+    /* 47 */ J_RMW_ALU(ZP, Op_LSR, Op_EOR),
+    /* 48 */ J_IMP(Op_PHA),
+    /* 49 */ J_READ(IMM, Op_EOR),
+    /* 4A */ J_RMW(ACC, Op_LSR),
+    /* 4B */ J_READ(IMM, Op_ALR),
+    /* 4C */ J_JUMP,
+    /* 4D */ J_READ(ABS, Op_EOR),
+    /* 4E */ J_RMW(ABS, Op_LSR),
+    /* 4F */ J_RMW_ALU(ABS, Op_LSR, Op_EOR),
+    /* 50 */ J_BRANCH(Cond_BVC),
+    /* 51 */ J_READ(INDY, Op_EOR),
+    /* 52 */ J_STOP(IMP),
+    /* 53 */ J_RMW_ALU(INDY, Op_LSR, Op_EOR),
+    /* 54 */ J_READ(ZPX, Op_NOP),
+    /* 55 */ J_READ(ZPX, Op_EOR),
+    /* 56 */ J_RMW(ZPX, Op_LSR),
+    /* 57 */ J_RMW_ALU(ZPX, Op_LSR, Op_EOR),
+    /* 58 */ J_IMP(Op_CLI),
+    /* 59 */ J_READ(ABSY, Op_EOR),
+    /* 5A */ J_IMP(Op_NOP),
+    /* 5B */ J_RMW_ALU(ABSY, Op_LSR, Op_EOR),
+    /* 5C */ J_READ(ABSX, Op_NOP),
+    /* 5D */ J_READ(ABSX, Op_EOR),
+    /* 5E */ J_RMW(ABSX, Op_LSR),
+    /* 5F */ J_RMW_ALU(ABSX, Op_LSR, Op_EOR),
+    /* 60 */ J_INTERP(IMP),
+    /* 61 */ J_READ(INDX, Op_ADC),
+    /* 62 */ J_STOP(IMP),
+    /* 63 */ J_RMW_ALU(INDX, Op_ROR, Op_ADC),
+    /* 64 */ J_READ(ZP, Op_NOP),
+    /* 65 */ J_READ(ZP, Op_ADC),
+    /* 66 */ J_RMW(ZP, Op_ROR),
+    /* 67 */ J_RMW_ALU(ZP, Op_ROR, Op_ADC),
+    /* 68 */ J_IMP(Op_PLA),
+    /* 69 */ J_READ(IMM, Op_ADC),
+    /* 6A */ J_RMW(ACC, Op_ROR),
+    /* 6B */ J_READ(IMM, Op_ARR),
+    /* 6C */ J_INTERP(IND),
+    /* 6D */ J_READ(ABS, Op_ADC),
+    /* 6E */ J_RMW(ABS, Op_ROR),
+    /* 6F */ J_RMW_ALU(ABS, Op_ROR, Op_ADC),
+    /* 70 */ J_BRANCH(Cond_BVS),
+    /* 71 */ J_READ(INDY, Op_ADC),
+    /* 72 */ J_STOP(IMP),
+    /* 73 */ J_RMW_ALU(INDY, Op_ROR, Op_ADC),
+    /* 74 */ J_READ(ZPX, Op_NOP),
+    /* 75 */ J_READ(ZPX, Op_ADC),
+    /* 76 */ J_RMW(ZPX, Op_ROR),
+    /* 77 */ J_RMW_ALU(ZPX, Op_ROR, Op_ADC),
+    /* 78 */ J_IMP(Op_SEI),
+    /* 79 */ J_READ(ABSY, Op_ADC),
+    /* 7A */ J_IMP(Op_NOP),
+    /* 7B */ J_RMW_ALU(ABSY, Op_ROR, Op_ADC),
+    /* 7C */ J_READ(ABSX, Op_NOP),
+    /* 7D */ J_READ(ABSX, Op_ADC),
+    /* 7E */ J_RMW(ABSX, Op_ROR),
+    /* 7F */ J_RMW_ALU(ABSX, Op_ROR, Op_ADC),
+    /* 80 */ J_READ(IMM, Op_NOP),
+    /* 81 */ J_WRITE(INDX, Src_A),
+    /* 82 */ J_READ(IMM, Op_NOP),
+    /* 83 */ J_WRITE(INDX, Src_AX),
+    /* 84 */ J_WRITE(ZP, Src_Y),
+    /* 85 */ J_WRITE(ZP, Src_A),
+    /* 86 */ J_WRITE(ZP, Src_X),
+    /* 87 */ J_WRITE(ZP, Src_AX),
+    /* 88 */ J_IMP(Op_DEY),
+    /* 89 */ J_READ(IMM, Op_NOP),
+    /* 8A */ J_IMP(Op_TXA),
+    /* 8B */ J_READ(IMM, Op_XAA),
+    /* 8C */ J_WRITE(ABS, Src_Y),
+    /* 8D */ J_WRITE(ABS, Src_A),
+    /* 8E */ J_WRITE(ABS, Src_X),
+    /* 8F */ J_WRITE(ABS, Src_AX),
+    /* 90 */ J_BRANCH(Cond_BCC),
+    /* 91 */ J_WRITE(INDY, Src_A),
+    /* 92 */ J_STOP(IMP),
+    /* 93 */ J_STOP(INDY),
+    /* 94 */ J_WRITE(ZPX, Src_Y),
+    /* 95 */ J_WRITE(ZPX, Src_A),
+    /* 96 */ J_WRITE(ZPY, Src_X),
+    /* 97 */ J_WRITE(ZPY, Src_AX),
+    /* 98 */ J_IMP(Op_TYA),
+    /* 99 */ J_WRITE(ABSY, Src_A),
+    /* 9A */ J_IMP(Op_TXS),
+    /* 9B */ J_STOP(ABSY),
+    /* 9C */ J_STOP(ABSX),
+    /* 9D */ J_WRITE(ABSX, Src_A),
+    /* 9E */ J_STOP(ABSY),
+    /* 9F */ J_STOP(ABSY),
+    /* A0 */ J_READ(IMM, Op_LDY),
+    /* A1 */ J_READ(INDX, Op_LDA),
+    /* A2 */ J_READ(IMM, Op_LDX),
+    /* A3 */ J_READ(INDX, Op_LAX),
+    /* A4 */ J_READ(ZP, Op_LDY),
+    /* A5 */ J_READ(ZP, Op_LDA),
+    /* A6 */ J_READ(ZP, Op_LDX),
+    /* A7 */ J_READ(ZP, Op_LAX),
+    /* A8 */ J_IMP(Op_TAY),
+    /* A9 */ J_READ(IMM, Op_LDA),
+    /* AA */ J_IMP(Op_TAX),
+    /* AB */ J_READ(IMM, Op_ATX),
+    /* AC */ J_READ(ABS, Op_LDY),
+    /* AD */ J_READ(ABS, Op_LDA),
+    /* AE */ J_READ(ABS, Op_LDX),
+    /* AF */ J_READ(ABS, Op_LAX),
+    /* B0 */ J_BRANCH(Cond_BCS),
+    /* B1 */ J_READ(INDY, Op_LDA),
+    /* B2 */ J_STOP(IMP),
+    /* B3 */ J_READ(INDY, Op_LAX),
+    /* B4 */ J_READ(ZPX, Op_LDY),
+    /* B5 */ J_READ(ZPX, Op_LDA),
+    /* B6 */ J_READ(ZPY, Op_LDX),
+    /* B7 */ J_READ(ZPY, Op_LAX),
+    /* B8 */ J_IMP(Op_CLV),
+    /* B9 */ J_READ(ABSY, Op_LDA),
+    /* BA */ J_IMP(Op_TSX),
+    /* BB */ J_READ(ABSY, Op_LAS),
+    /* BC */ J_READ(ABSX, Op_LDY),
+    /* BD */ J_READ(ABSX, Op_LDA),
+    /* BE */ J_READ(ABSY, Op_LDX),
+    /* BF */ J_READ(ABSY, Op_LAX),
+    /* C0 */ J_READ(IMM, Op_CPY),
+    /* C1 */ J_READ(INDX, Op_CMP),
+    /* C2 */ J_READ(IMM, Op_NOP),
+    /* C3 */ J_RMW_ALU(INDX, Op_DEC, Op_CMP),
+    /* C4 */ J_READ(ZP, Op_CPY),
+    /* C5 */ J_READ(ZP, Op_CMP),
+    /* C6 */ J_RMW(ZP, Op_DEC),
+    /* C7 */ J_RMW_ALU(ZP, Op_DEC, Op_CMP),
+    /* C8 */ J_IMP(Op_INY),
+    /* C9 */ J_READ(IMM, Op_CMP),
+    /* CA */ J_IMP(Op_DEX),
+    /* CB */ J_READ(IMM, Op_AXS),
+    /* CC */ J_READ(ABS, Op_CPY),
+    /* CD */ J_READ(ABS, Op_CMP),
+    /* CE */ J_RMW(ABS, Op_DEC),
+    /* CF */ J_RMW_ALU(ABS, Op_DEC, Op_CMP),
+    /* D0 */ J_BRANCH(Cond_BNE),
+    /* D1 */ J_READ(INDY, Op_CMP),
+    /* D2 */ J_STOP(IMP),
+    /* D3 */ J_RMW_ALU(INDY, Op_DEC, Op_CMP),
+    /* D4 */ J_READ(ZPX, Op_NOP),
+    /* D5 */ J_READ(ZPX, Op_CMP),
+    /* D6 */ J_RMW(ZPX, Op_DEC),
+    /* D7 */ J_RMW_ALU(ZPX, Op_DEC, Op_CMP),
+    /* D8 */ J_IMP(Op_CLD),
+    /* D9 */ J_READ(ABSY, Op_CMP),
+    /* DA */ J_IMP(Op_NOP),
+    /* DB */ J_RMW_ALU(ABSY, Op_DEC, Op_CMP),
+    /* DC */ J_READ(ABSX, Op_NOP),
+    /* DD */ J_READ(ABSX, Op_CMP),
+    /* DE */ J_RMW(ABSX, Op_DEC),
+    /* DF */ J_RMW_ALU(ABSX, Op_DEC, Op_CMP),
+    /* E0 */ J_READ(IMM, Op_CPX),
+    /* E1 */ J_READ(INDX, Op_SBC),
+    /* E2 */ J_READ(IMM, Op_NOP),
+    /* E3 */ J_RMW_ALU(INDX, Op_INC, Op_SBC),
+    /* E4 */ J_READ(ZP, Op_CPX),
+    /* E5 */ J_READ(ZP, Op_SBC),
+    /* E6 */ J_RMW(ZP, Op_INC),
+    /* E7 */ J_RMW_ALU(ZP, Op_INC, Op_SBC),
+    /* E8 */ J_IMP(Op_INX),
+    /* E9 */ J_READ(IMM, Op_SBC),
+    /* EA */ J_IMP(Op_NOP),
+    /* EB */ J_READ(IMM, Op_SBC),
+    /* EC */ J_READ(ABS, Op_CPX),
+    /* ED */ J_READ(ABS, Op_SBC),
+    /* EE */ J_RMW(ABS, Op_INC),
+    /* EF */ J_RMW_ALU(ABS, Op_INC, Op_SBC),
+    /* F0 */ J_BRANCH(Cond_BEQ),
+    /* F1 */ J_READ(INDY, Op_SBC),
+    /* F2 */ J_STOP(IMP),
+    /* F3 */ J_RMW_ALU(INDY, Op_INC, Op_SBC),
+    /* F4 */ J_READ(ZPX, Op_NOP),
+    /* F5 */ J_READ(ZPX, Op_SBC),
+    /* F6 */ J_RMW(ZPX, Op_INC),
+    /* F7 */ J_RMW_ALU(ZPX, Op_INC, Op_SBC),
+    /* F8 */ J_IMP(Op_SED),
+    /* F9 */ J_READ(ABSY, Op_SBC),
+    /* FA */ J_IMP(Op_NOP),
+    /* FB */ J_RMW_ALU(ABSY, Op_INC, Op_SBC),
+    /* FC */ J_READ(ABSX, Op_NOP),
+    /* FD */ J_READ(ABSX, Op_SBC),
+    /* FE */ J_RMW(ABSX, Op_INC),
+    /* FF */ J_RMW_ALU(ABSX, Op_INC, Op_SBC),
+};
+
+#undef J_READ
+#undef J_WRITE
+#undef J_RMW
+#undef J_RMW_ALU
+#undef J_IMP
+#undef J_BRANCH
+#undef J_JUMP
+#undef J_INTERP
+#undef J_STOP
+
+// The shapes restate policies_map.hpp by hand, so hold them to the tables
+// the decoder uses: every mode must account for the opcode's length, and
+// exactly the shapes that leave the block (branch, jump, interpreted
+// control flow, JAM) may sit on a block-ending opcode. Whether the
+// policies match the Instr<> bodies is left to `make test_jit`.
+static constexpr std::uint8_t modeLength(JitMode mode) {
+    switch (mode) {
+        case JitMode::IMP:
+        case JitMode::ACC:
+            return 1;
+        case JitMode::ABS:
+        case JitMode::ABSX:
+        case JitMode::ABSY:
+        case JitMode::IND:
+            return 3;
+        default:
+            return 2;
+    }
+}
+
+static constexpr bool shapeMatches(int opcode) {
+    const JitShape& shape = jit_shapes[opcode];
+    const std::uint8_t op = static_cast<std::uint8_t>(opcode);
+    if (modeLength(shape.mode) != instr_length[op]) return false;
+
+    switch (shape.kind) {
+        case JitKind::Branch:
+            return (op & 0x1F) == 0x10 && shape.native != JitNative::None;
+        case JitKind::Jump:
+            return op == 0x4C;
+        case JitKind::Interp:
+            return instr_ends_block(op);
+        case JitKind::Stop:
+            return !instr_ends_block(op) || shape.mode == JitMode::IMP;
+        default:
+            return !instr_ends_block(op);
+    }
+}
+
+static constexpr bool shapesMatch() {
+    for (int opcode = 0; opcode < 256; ++opcode) {
+        if (!shapeMatches(opcode)) return false;
+    }
+    return true;
+}
+
+static_assert(shapesMatch(), "jit_shapes disagrees with instr_length or instr_ends_block");
+
+// =============================================================
+// X86-64 EMITTER
+// -----------------
+// Only the handful of encodings the translator needs. Fixed register use:
+//   rbx = CpuRegisters*, rbp = RAM index kept across calls,
+//   r12 = Bus*, r14 = internal RAM, r15 = Core*
+// eax/ecx/edx/esi/edi are scratch and clobbered by calls.
+// =============================================================
+
+class Emitter {
+    public:
+        enum Reg : std::uint8_t { EAX = 0, ECX = 1, EDX = 2, EBX = 3, ESP = 4, EBP = 5, ESI = 6, EDI = 7 };
+        enum Alu : std::uint8_t { ADD = 0, OR = 1, AND = 4, SUB = 5, XOR = 6, CMP = 7 };
+        enum Cond : std::uint8_t { B = 2, AE = 3, E = 4, NE = 5 };
+
+        std::vector<std::uint8_t> buf;
+
+        std::size_t size() const { return buf.size(); }
+
+        void prologue() {
+            bytes({0x53, 0x55, 0x41, 0x54, 0x41, 0x56, 0x41, 0x57}); // push rbx, rbp, r12, r14, r15
+            bytes({0x49, 0x89, 0xFF});                               // mov r15, rdi
+            bytes({0x48, 0x89, 0xF3});                               // mov rbx, rsi
+            bytes({0x49, 0x89, 0xD6});                               // mov r14, rdx
+            bytes({0x49, 0x89, 0xCC});                               // mov r12, rcx
+        }
+
+        void epilogue() {
+            bytes({0x41, 0x5F, 0x41, 0x5E, 0x41, 0x5C, 0x5D, 0x5B, 0xC3});
+        }
+
+        // movzx r, byte [rbx+off] / mov byte [rbx+off], r / mov byte [rbx+off], imm
+        void loadReg(Reg r, std::uint8_t off) { bytes({0x0F, 0xB6, modrmRbx(r), off}); }
+        void storeReg(std::uint8_t off, Reg r) { if (r >= ESP) byte(0x40); bytes({0x88, modrmRbx(r), off}); }
+        void storeImm(std::uint8_t off, std::uint8_t v) { bytes({0xC6, modrmRbx(0), off, v}); }
+        void storeImm16(std::uint8_t off, std::uint16_t v) { bytes({0x66, 0xC7, modrmRbx(0), off}); imm16(v); }
+        void incMem(std::uint8_t off) { bytes({0xFE, modrmRbx(0), off}); }
+        void decMem(std::uint8_t off) { bytes({0xFE, modrmRbx(1), off}); }
+        void testMem(std::uint8_t off, std::uint8_t v) { bytes({0xF6, modrmRbx(0), off, v}); }
+        void cmpMem(std::uint8_t off, std::uint8_t v) { bytes({0x80, modrmRbx(7), off, v}); }
+
+        // movzx r, byte [r14+idx] / mov byte [r14+idx], r / same with disp32
+        void loadRam(Reg r, Reg idx) { bytes({0x41, 0x0F, 0xB6, static_cast<std::uint8_t>(0x04 | r << 3), sibR14(idx)}); }
+        void storeRam(Reg idx, Reg r) { bytes({0x41, 0x88, static_cast<std::uint8_t>(0x04 | r << 3), sibR14(idx)}); }
+        void loadRam(Reg r, std::uint32_t disp) { bytes({0x41, 0x0F, 0xB6, static_cast<std::uint8_t>(0x86 | r << 3)}); imm32(disp); }
+        void storeRam(std::uint32_t disp, Reg r) { bytes({0x41, 0x88, static_cast<std::uint8_t>(0x86 | r << 3)}); imm32(disp); }
+
+        void movImm(Reg r, std::uint32_t v) { byte(static_cast<std::uint8_t>(0xB8 + r)); imm32(v); }
+        void mov(Reg dst, Reg src) { bytes({0x89, modrmRR(src, dst)}); }
+        void alu(Alu op, Reg dst, Reg src) { bytes({static_cast<std::uint8_t>(op * 8 + 1), modrmRR(src, dst)}); }
+        void alu(Alu op, Reg r, std::uint32_t v) { bytes({0x81, modrmRR(op, r)}); imm32(v); }
+        void shl(Reg r, std::uint8_t n) { bytes({0xC1, modrmRR(4, r), n}); }
+        void shr(Reg r, std::uint8_t n) { bytes({0xC1, modrmRR(5, r), n}); }
+        void notr(Reg r) { bytes({0xF7, modrmRR(2, r)}); }
+        void setcc(Cond cc, Reg r) { bytes({0x0F, static_cast<std::uint8_t>(0x90 + cc), modrmRR(0, r)}); }
+
+        void argCore() { bytes({0x4C, 0x89, 0xFF}); } // mov rdi, r15
+        void argBus() { bytes({0x4C, 0x89, 0xE7}); }  // mov rdi, r12
+        void argPtr(const void* p) { bytes({0x48, 0xBE}); imm64(reinterpret_cast<std::uint64_t>(p)); } // mov rsi, imm64
+
+        template <typename FN>
+        void call(FN fn) {
+            bytes({0x48, 0xB8}); // mov rax, imm64; call rax
+            imm64(reinterpret_cast<std::uint64_t>(fn));
+            bytes({0xFF, 0xD0});
+        }
+
+        // Forward jumps: returns the rel32 slot to bind() later
+        std::size_t jcc(Cond cc) { bytes({0x0F, static_cast<std::uint8_t>(0x80 + cc)}); imm32(0); return buf.size() - 4; }
+        std::size_t jmp() { byte(0xE9); imm32(0); return buf.size() - 4; }
+        void bind(std::size_t slot) {
+            std::uint32_t rel = static_cast<std::uint32_t>(buf.size() - (slot + 4));
+            std::memcpy(&buf[slot], &rel, 4);
+        }
+
+    private:
+        static std::uint8_t modrmRbx(std::uint8_t r) { return static_cast<std::uint8_t>(0x43 | r << 3); }
+        static std::uint8_t modrmRR(std::uint8_t reg, std::uint8_t rm) { return static_cast<std::uint8_t>(0xC0 | reg << 3 | rm); }
+        static std::uint8_t sibR14(Reg idx) { return static_cast<std::uint8_t>(idx << 3 | 0x06); }
+
+        void byte(std::uint8_t b) { buf.push_back(b); }
+        void bytes(std::initializer_list<std::uint8_t> bs) { buf.insert(buf.end(), bs); }
+        void imm16(std::uint16_t v) { byte(v & 0xFF); byte(v >> 8); }
+        void imm32(std::uint32_t v) { for (int i = 0; i < 4; ++i) byte((v >> (i * 8)) & 0xFF); }
+        void imm64(std::uint64_t v) { for (int i = 0; i < 8; ++i) byte((v >> (i * 8)) & 0xFF); }
+};
+
+// =============================================================
+// TRANSLATOR
+// =============================================================
+
+static constexpr std::uint8_t REG_PC = offsetof(CpuRegisters, pc);
+static constexpr std::uint8_t REG_A  = offsetof(CpuRegisters, a);
+static constexpr std::uint8_t REG_X  = offsetof(CpuRegisters, x);
+static constexpr std::uint8_t REG_Y  = offsetof(CpuRegisters, y);
+static constexpr std::uint8_t REG_S  = offsetof(CpuRegisters, s);
+static constexpr std::uint8_t REG_C  = offsetof(CpuRegisters, c);
+static constexpr std::uint8_t REG_I  = offsetof(CpuRegisters, i);
+static constexpr std::uint8_t REG_D  = offsetof(CpuRegisters, d);
+static constexpr std::uint8_t REG_V  = offsetof(CpuRegisters, v);
+static constexpr std::uint8_t REG_Z  = offsetof(CpuRegisters, z_src);
+static constexpr std::uint8_t REG_N  = offsetof(CpuRegisters, n_src);
+
+using R = Emitter::Reg;
+
+static bool isIO(std::uint32_t addr) { return addr >= 0x2000 && addr < 0x6000; }
+
+static std::uint16_t operandWord(const DecodedInstr& ins) {
+    return static_cast<std::uint16_t>(ins.operand[0] | (ins.operand[1] << 8));
+}
+
+// Whether the instruction can be translated at all. Static I/O (or
+// non-RAM write) targets end the native block before the instruction.
+static bool translatable(const DecodedInstr& ins, const JitShape& shape) {
+    switch (shape.kind) {
+        case JitKind::Stop:
+            return false;
+        case JitKind::Read:
+            return shape.mode != JitMode::ABS || !isIO(operandWord(ins));
+        case JitKind::Write:
+        case JitKind::Rmw:
+        case JitKind::RmwAlu:
+            return shape.mode != JitMode::ABS || operandWord(ins) < 0x2000;
+        case JitKind::Interp:
+            return shape.mode != JitMode::IND || !isIO(operandWord(ins));
+        default:
+            return true;
+    }
+}
+
+class Translator {
+    public:
+        Translator(Bus& bus, std::deque<DecodedInstr>& interp_instrs) : bus(bus), interp_instrs(interp_instrs) {}
+
+        // Emits the longest translatable prefix of the block. Returns the
+        // most cycles any path through it can charge, 0 if nothing fit.
+        int translate(const DecodedBlock& block, std::vector<std::uint8_t>& out) {
+            e.prologue();
+
+            std::uint16_t next_pc = block.instrs.front().pc;
+            bool closed = false;
+            for (const DecodedInstr& ins : block.instrs) {
+                const JitShape& shape = jit_shapes[ins.opcode];
+                if (!translatable(ins, shape)) break;
+
+                closed = emit(ins, shape);
+                next_pc = static_cast<std::uint16_t>(ins.pc + ins.length);
+                if (closed) break;
+                // CLI and PLP can unmask a pending IRQ: let step() look
+                if (ins.opcode == 0x58 || ins.opcode == 0x28) break;
+            }
+            if (cycles == 0 && !closed) return 0;
+
+            if (!closed) exitTo(next_pc, cycles);
+
+            for (const SideExit& x : side_exits) {
+                e.bind(x.slot);
+                exitTo(x.pc, x.cycles);
+            }
+
+            out = std::move(e.buf);
+            return max_cycles;
+        }
+
+    private:
+        struct SideExit { std::size_t slot; std::uint16_t pc; int cycles; };
+
+        Bus& bus;
+        std::deque<DecodedInstr>& interp_instrs;
+        Emitter e;
+        std::vector<SideExit> side_exits;
+        int cycles = 0;     // Charged by everything before the current instruction
+        int max_cycles = 0;
+
+        void exitTo(std::uint16_t pc, int total) {
+            e.storeImm16(REG_PC, pc);
+            exitKeepPC(total);
+        }
+
+        void exitKeepPC(int total) {
+            e.movImm(R::EAX, static_cast<std::uint32_t>(total));
+            e.epilogue();
+            if (total > max_cycles) max_cycles = total;
+        }
+
+        // Leave before the current instruction if the condition holds
+        void sideExitIf(Emitter::Cond cc, const DecodedInstr& ins) {
+            side_exits.push_back({e.jcc(cc), ins.pc, cycles});
+            if (cycles > max_cycles) max_cycles = cycles;
+        }
+
+        void setZN(R r) {
+            e.storeReg(REG_Z, r);
+            e.storeReg(REG_N, r);
+        }
+
+        // Effective address of the indexed/indirect modes into ecx
+        void emitAddress(const DecodedInstr& ins, JitMode mode) {
+            switch (mode) {
+                case JitMode::ZPX:
+                case JitMode::ZPY:
+                    e.loadReg(R::ECX, mode == JitMode::ZPX ? REG_X : REG_Y);
+                    e.alu(Emitter::ADD, R::ECX, ins.operand[0]);
+                    e.alu(Emitter::AND, R::ECX, 0xFFu);
+                    break;
+                case JitMode::ABSX:
+                case JitMode::ABSY:
+                    e.loadReg(R::ECX, mode == JitMode::ABSX ? REG_X : REG_Y);
+                    e.alu(Emitter::ADD, R::ECX, operandWord(ins));
+                    e.alu(Emitter::AND, R::ECX, 0xFFFFu);
+                    break;
+                case JitMode::INDX:
+                    e.loadReg(R::ECX, REG_X);
+                    e.alu(Emitter::ADD, R::ECX, ins.operand[0]);
+                    e.alu(Emitter::AND, R::ECX, 0xFFu);
+                    e.loadRam(R::EAX, R::ECX);
+                    e.alu(Emitter::ADD, R::ECX, 1u);
+                    e.alu(Emitter::AND, R::ECX, 0xFFu);
+                    e.loadRam(R::ECX, R::ECX);
+                    e.shl(R::ECX, 8);
+                    e.alu(Emitter::OR, R::ECX, R::EAX);
+                    break;
+                case JitMode::INDY:
+                    e.loadRam(R::EAX, static_cast<std::uint32_t>(ins.operand[0]));
+                    e.loadRam(R::ECX, static_cast<std::uint32_t>((ins.operand[0] + 1) & 0xFF));
+                    e.shl(R::ECX, 8);
+                    e.alu(Emitter::OR, R::ECX, R::EAX);
+                    e.loadReg(R::EAX, REG_Y);
+                    e.alu(Emitter::ADD, R::ECX, R::EAX);
+                    e.alu(Emitter::AND, R::ECX, 0xFFFFu);
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        // Operand value of a read into edx
+        void emitReadValue(const DecodedInstr& ins, JitMode mode) {
+            if (mode == JitMode::IMM) {
+                e.movImm(R::EDX, ins.operand[0]);
+                return;
+            }
+            if (mode == JitMode::ZP || mode == JitMode::ABS) {
+                std::uint16_t addr = mode == JitMode::ZP ? ins.operand[0] : operandWord(ins);
+                if (addr < 0x2000) {
+                    e.loadRam(R::EDX, static_cast<std::uint32_t>(addr & 0x07FF));
+                } else if (addr >= 0x8000) {
+                    e.movImm(R::EDX, bus.read(addr)); // PRG ROM is constant for this block's lifetime
+                } else {
+                    e.argBus();
+                    e.movImm(R::ESI, addr);
+                    e.call(&callBusRead);
+                    e.mov(R::EDX, R::EAX);
+                }
+                return;
+            }
+
+            emitAddress(ins, mode);
+            if (mode == JitMode::ZPX || mode == JitMode::ZPY) {
+                e.loadRam(R::EDX, R::ECX);
+                return;
+            }
+
+            e.alu(Emitter::CMP, R::ECX, 0x2000u);
+            std::size_t high = e.jcc(Emitter::AE);
+            e.mov(R::EDX, R::ECX);
+            e.alu(Emitter::AND, R::EDX, 0x07FFu);
+            e.loadRam(R::EDX, R::EDX);
+            std::size_t done = e.jmp();
+
+            e.bind(high);
+            e.alu(Emitter::CMP, R::ECX, 0x6000u);
+            sideExitIf(Emitter::B, ins);
+            e.argBus();
+            e.mov(R::ESI, R::ECX);
+            e.call(&callBusRead);
+            e.mov(R::EDX, R::EAX);
+            e.bind(done);
+        }
+
+        // Internal RAM target of a write or RMW: a static offset, or ebp
+        // after a guard. Returns true when the target is in ebp.
+        bool emitRamTarget(const DecodedInstr& ins, JitMode mode, std::uint32_t& disp) {
+            if (mode == JitMode::ZP || mode == JitMode::ABS) {
+                disp = (mode == JitMode::ZP ? ins.operand[0] : operandWord(ins)) & 0x07FF;
+                return false;
+            }
+            emitAddress(ins, mode);
+            if (mode != JitMode::ZPX && mode != JitMode::ZPY) {
+                e.alu(Emitter::CMP, R::ECX, 0x2000u);
+                sideExitIf(Emitter::AE, ins);
+                e.alu(Emitter::AND, R::ECX, 0x07FFu);
+            }
+            e.mov(R::EBP, R::ECX);
+            return true;
+        }
+
+        void loadTarget(bool indexed, std::uint32_t disp, R r) {
+            if (indexed) e.loadRam(r, R::EBP); else e.loadRam(r, disp);
+        }
+
+        void storeTarget(bool indexed, std::uint32_t disp, R r) {
+            if (indexed) e.storeRam(R::EBP, r); else e.storeRam(disp, r);
+        }
+
+        // A + edx + C, as AddWithCarry (binary mode)
+        void emitAdc() {
+            e.loadReg(R::EAX, REG_A);
+            e.loadReg(R::ECX, REG_C);
+            e.mov(R::ESI, R::EAX);
+            e.alu(Emitter::ADD, R::ESI, R::EDX);
+            e.alu(Emitter::ADD, R::ESI, R::ECX);
+            e.mov(R::ECX, R::ESI);
+            e.shr(R::ECX, 8);
+            e.storeReg(REG_C, R::ECX);
+            e.alu(Emitter::XOR, R::EAX, R::ESI); // V = (A ^ r) & (M ^ r) & 0x80
+            e.alu(Emitter::XOR, R::EDX, R::ESI);
+            e.alu(Emitter::AND, R::EAX, R::EDX);
+            e.shr(R::EAX, 7);
+            e.alu(Emitter::AND, R::EAX, 1u);
+            e.storeReg(REG_V, R::EAX);
+            e.storeReg(REG_A, R::ESI);
+            setZN(R::ESI);
+        }
+
+        void emitCompare(std::uint8_t reg) {
+            e.loadReg(R::EAX, reg);
+            e.mov(R::ECX, R::EAX);
+            e.alu(Emitter::SUB, R::ECX, R::EDX);
+            e.alu(Emitter::CMP, R::EAX, R::EDX);
+            e.setcc(Emitter::AE, R::EAX);
+            e.storeReg(REG_C, R::EAX);
+            setZN(R::ECX);
+        }
+
+        void emitLogic(Emitter::Alu op) {
+            e.loadReg(R::EAX, REG_A);
+            e.alu(op, R::EAX, R::EDX);
+            e.storeReg(REG_A, R::EAX);
+            setZN(R::EAX);
+        }
+
+        void emitTransfer(std::uint8_t from, std::uint8_t to, bool flags) {
+            e.loadReg(R::EAX, from);
+            e.storeReg(to, R::EAX);
+            if (flags) setZN(R::EAX);
+        }
+
+        void emitStep(std::uint8_t reg, bool inc) {
+            if (inc) e.incMem(reg); else e.decMem(reg);
+            e.loadReg(R::EAX, reg);
+            setZN(R::EAX);
+        }
+
+        void emitRead(const DecodedInstr& ins, const JitShape& shape) {
+            emitReadValue(ins, shape.mode);
+            switch (shape.native) {
+                case JitNative::NOP: break;
+                case JitNative::LDA: e.storeReg(REG_A, R::EDX); setZN(R::EDX); break;
+                case JitNative::LDX: e.storeReg(REG_X, R::EDX); setZN(R::EDX); break;
+                case JitNative::LDY: e.storeReg(REG_Y, R::EDX); setZN(R::EDX); break;
+                case JitNative::AND: emitLogic(Emitter::AND); break;
+                case JitNative::ORA: emitLogic(Emitter::OR); break;
+                case JitNative::EOR: emitLogic(Emitter::XOR); break;
+                case JitNative::CMP: emitCompare(REG_A); break;
+                case JitNative::CPX: emitCompare(REG_X); break;
+                case JitNative::CPY: emitCompare(REG_Y); break;
+                case JitNative::ADC: emitAdc(); break;
+                case JitNative::SBC:
+                    e.notr(R::EDX);
+                    e.alu(Emitter::AND, R::EDX, 0xFFu);
+                    emitAdc();
+                    break;
+                default:
+                    e.argCore();
+                    e.mov(R::ESI, R::EDX);
+                    e.call(shape.exec);
+                    break;
+            }
+        }
+
+        void emitWrite(const DecodedInstr& ins, const JitShape& shape) {
+            std::uint32_t disp = 0;
+            bool indexed = emitRamTarget(ins, shape.mode, disp);
+            switch (shape.native) {
+                case JitNative::SrcA: e.loadReg(R::EDX, REG_A); break;
+                case JitNative::SrcX: e.loadReg(R::EDX, REG_X); break;
+                case JitNative::SrcY: e.loadReg(R::EDX, REG_Y); break;
+                default:
+                    e.argCore();
+                    e.call(shape.calc);
+                    e.mov(R::EDX, R::EAX);
+                    break;
+            }
+            storeTarget(indexed, disp, R::EDX);
+        }
+
+        void emitRmw(const DecodedInstr& ins, const JitShape& shape) {
+            if (shape.mode == JitMode::ACC) {
+                e.argCore();
+                e.loadReg(R::ESI, REG_A);
+                e.call(shape.calc);
+                e.storeReg(REG_A, R::EAX);
+                return;
+            }
+
+            std::uint32_t disp = 0;
+            bool indexed = emitRamTarget(ins, shape.mode, disp);
+            if (shape.native == JitNative::INC || shape.native == JitNative::DEC) {
+                loadTarget(indexed, disp, R::EDX);
+                e.alu(Emitter::ADD, R::EDX, shape.native == JitNative::INC ? 0x01u : 0xFFu);
+                storeTarget(indexed, disp, R::EDX);
+                setZN(R::EDX);
+                return;
+            }
+
+            e.argCore();
+            loadTarget(indexed, disp, R::ESI);
+            e.call(shape.calc);
+            storeTarget(indexed, disp, R::EAX);
+            if (shape.kind == JitKind::RmwAlu) {
+                e.argCore();
+                e.mov(R::ESI, R::EAX);
+                e.call(shape.exec);
+            }
+        }
+
+        void emitImplied(const JitShape& shape) {
+            switch (shape.native) {
+                case JitNative::NOP: break;
+                case JitNative::TAX: emitTransfer(REG_A, REG_X, true); break;
+                case JitNative::TAY: emitTransfer(REG_A, REG_Y, true); break;
+                case JitNative::TXA: emitTransfer(REG_X, REG_A, true); break;
+                case JitNative::TYA: emitTransfer(REG_Y, REG_A, true); break;
+                case JitNative::TSX: emitTransfer(REG_S, REG_X, true); break;
+                case JitNative::TXS: emitTransfer(REG_X, REG_S, false); break;
+                case JitNative::INX: emitStep(REG_X, true); break;
+                case JitNative::INY: emitStep(REG_Y, true); break;
+                case JitNative::DEX: emitStep(REG_X, false); break;
+                case JitNative::DEY: emitStep(REG_Y, false); break;
+                case JitNative::CLC: e.storeImm(REG_C, 0); break;
+                case JitNative::SEC: e.storeImm(REG_C, 1); break;
+                case JitNative::CLD: e.storeImm(REG_D, 0); break;
+                case JitNative::SED: e.storeImm(REG_D, 1); break;
+                case JitNative::CLV: e.storeImm(REG_V, 0); break;
+                case JitNative::SEI: e.storeImm(REG_I, 1); break;
+                default:
+                    e.argCore();
+                    e.movImm(R::ESI, 0);
+                    e.call(shape.exec);
+                    break;
+            }
+        }
+
+        // Branch timing as ExecBranchCycles: 2, +1 taken, +1 page crossed
+        void emitBranch(const DecodedInstr& ins, const JitShape& shape) {
+            Emitter::Cond taken_if = Emitter::NE;
+            switch (shape.native) {
+                case JitNative::BPL: e.testMem(REG_N, 0x80); taken_if = Emitter::E; break;
+                case JitNative::BMI: e.testMem(REG_N, 0x80); taken_if = Emitter::NE; break;
+                case JitNative::BVC: e.cmpMem(REG_V, 0); taken_if = Emitter::E; break;
+                case JitNative::BVS: e.cmpMem(REG_V, 0); taken_if = Emitter::NE; break;
+                case JitNative::BCC: e.cmpMem(REG_C, 0); taken_if = Emitter::E; break;
+                case JitNative::BCS: e.cmpMem(REG_C, 0); taken_if = Emitter::NE; break;
+                case JitNative::BNE: e.cmpMem(REG_Z, 0); taken_if = Emitter::NE; break;
+                case JitNative::BEQ: e.cmpMem(REG_Z, 0); taken_if = Emitter::E; break;
+                default: break;
+            }
+            std::uint16_t next = static_cast<std::uint16_t>(ins.pc + 2);
+            std::uint16_t target = static_cast<std::uint16_t>(next + static_cast<std::int8_t>(ins.operand[0]));
+            int taken_cycles = 3 + ((next & 0xFF00) != (target & 0xFF00) ? 1 : 0);
+
+            std::size_t taken = e.jcc(taken_if);
+            exitTo(next, cycles + 2);
+            e.bind(taken);
+            exitTo(target, cycles + taken_cycles);
+        }
+
+        // Returns true if the instruction ended the block
+        bool emit(const DecodedInstr& ins, const JitShape& shape) {
+            switch (shape.kind) {
+                case JitKind::Read:    emitRead(ins, shape); break;
+                case JitKind::Write:   emitWrite(ins, shape); break;
+                case JitKind::Rmw:
+                case JitKind::RmwAlu:  emitRmw(ins, shape); break;
+                case JitKind::Implied: emitImplied(shape); break;
+                case JitKind::Branch:
+                    emitBranch(ins, shape);
+                    return true;
+                case JitKind::Jump:
+                    exitTo(operandWord(ins), cycles + instr_cycles[ins.opcode]);
+                    return true;
+                case JitKind::Interp:
+                    interp_instrs.push_back(ins);
+                    e.argCore();
+                    e.argPtr(&interp_instrs.back());
+                    e.call(&callInterpret);
+                    exitKeepPC(cycles + instr_cycles[ins.opcode]);
+                    return true;
+                case JitKind::Stop:
+                    break;
+            }
+            cycles += instr_cycles[ins.opcode];
+            return false;
+        }
+};
+
+// =============================================================
+// JIT CACHE
+// =============================================================
+
+// The arena is never writable and executable at once: pages start RW,
+// compile() turns the ones it fills RX and opens them to writes again
+// only while it copies the next block in
+Jit::Jit() {
+    void* mem = mmap(nullptr, CODE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mem == MAP_FAILED) {
+        log("JIT", "Code memory unavailable, running interpreted.");
+        return;
+    }
+    code = static_cast<std::uint8_t*>(mem);
+    entries.resize(0x8000);
+}
+
+Jit::~Jit() {
+    if (code) munmap(code, CODE_SIZE);
+}
+
+void Jit::flush() {
+    for (std::uint16_t index : filled) {
+        entries[index] = Entry{};
+    }
+    filled.clear();
+    interp_instrs.clear();
+    code_used = 0;
+}
+
+int Jit::run(Core& core, Bus& bus, BlockCache& cache) {
+    std::uint16_t pc = core.regs.pc;
+    if (!code || pc < 0x8000) return 0;
+
+    // Stale blocks are dropped by the interpreter's next lookup first
+    if (!cache.valid(bus)) return 0;
+    if (cache.generation() != generation) {
+        flush();
+        generation = cache.generation();
+    }
+
+    Entry& entry = entries[pc - 0x8000];
+    if (!entry.fn) {
+        if (entry.failed) return 0;
+        if (entry.hits == 0) filled.push_back(static_cast<std::uint16_t>(pc - 0x8000));
+        if (++entry.hits < HOT_THRESHOLD) return 0;
+
+        // Make room first so a full arena never costs a hot block
+        if (CODE_SIZE - code_used < MAX_BLOCK_CODE) {
+            flush();
+            filled.push_back(static_cast<std::uint16_t>(pc - 0x8000));
+            entry.hits = HOT_THRESHOLD;
+        }
+
+        const DecodedBlock* block = cache.lookup(bus, pc);
+        if (!block || !compile(bus, *block, entry)) {
+            entry.failed = true;
+            return 0;
+        }
+    }
+
+    if (entry.max_cycles > bus.cpuCyclesUntilInterrupt(core.regs.i)) return 0;
+    return entry.fn(&core, &core.regs, bus.getRam(), &bus);
+}
+
+bool Jit::compile(Bus& bus, const DecodedBlock& block, Entry& entry) {
+    std::vector<std::uint8_t> native;
+    Translator translator(bus, interp_instrs);
+    int max_cycles = translator.translate(block, native);
+    if (max_cycles == 0) return false;
+
+    if (native.size() > CODE_SIZE - code_used) return false;
+
+    // Whole pages around the new code; earlier blocks on the first one are
+    // not running while it is written
+    static const std::size_t page = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    const std::size_t begin = code_used & ~(page - 1);
+    const std::size_t end = std::min(CODE_SIZE, (code_used + native.size() + page - 1) & ~(page - 1));
+    if (mprotect(code + begin, end - begin, PROT_READ | PROT_WRITE) != 0) return false;
+    std::memcpy(code + code_used, native.data(), native.size());
+    if (mprotect(code + begin, end - begin, PROT_READ | PROT_EXEC) != 0) {
+        log("JIT", "Code memory cannot be made executable, running interpreted.");
+        flush();
+        munmap(code, CODE_SIZE);
+        code = nullptr;
+        return false;
+    }
+
+    entry.fn = reinterpret_cast<BlockFn>(code + code_used);
+    entry.max_cycles = max_cycles;
+    code_used += (native.size() + 15) & ~static_cast<std::size_t>(15);
+    return true;
+}
+
+#endif // CPU_JIT
@@ -4,6 +4,9 @@
 #include <chrono>
 #include <csignal>
 #include <memory>
+#include <algorithm>
+#include <cstdlib>
+#include <string>
 
 #include "bus.hpp"
 #include "core.hpp"
@@ -11,18 +14,30 @@
 #include "logger.hpp"
 #include "policies_map.hpp"
 #include "cartridge.hpp"
+#include "scheduler.hpp"
+#include "deferred.hpp"
 
 volatile std::sig_atomic_t g_signal_received = 0;
 void signal_handler(int signal) { g_signal_received = signal; }
 
 int main(int argc, char** argv) {
     if (argc < 2) {
-        std::cerr << "Usage: " << argv[0] << " <rom_file>\n";
+        std::cerr << "Usage: " << argv[0] << " <rom_file> [frameskip] [render_threads] [blep|sinc]\n";
         return 1;
     }
 
+    // Draw one frame in (frameskip + 1); the others only run for timing
+    const int frameskip = argc > 2 ? std::max(0, std::atoi(argv[2])) : 0;
+
+    // Compose pixels on this many worker threads instead (0: this thread)
+    const int render_threads = argc > 3 ? std::max(0, std::atoi(argv[3])) : 0;
+
+    // Audio filter: band-limited steps (default) or the windowed-sinc decimator
+    const bool sinc_audio = argc > 4 && std::string(argv[4]) == "sinc";
+
     // 1. Initialize Systems
     Bus bus;
+    if (sinc_audio) bus.apu.setAudioFilter(APU::AudioFilter::SINC);
     Renderer renderer;
     if (!renderer.init("NES Emulator", 256, 240, 1)) return 1;
 
@@ -41,6 +56,14 @@ int main(int argc, char** argv) {
     init_instr_table(core);
     bus.reset();
     core.init();
+
+    Scheduler scheduler(core, bus);
+
+    std::unique_ptr<DeferredRenderer> deferred;
+    if (render_threads > 0) {
+        deferred = std::make_unique<DeferredRenderer>(render_threads);
+        bus.setDeferredRenderer(deferred.get());
+    }
     
     std::signal(SIGINT, signal_handler);
     
@@ -50,34 +73,20 @@ int main(int argc, char** argv) {
     auto frame_end = clock::now();
     auto frame_duration = frame_end - frame_start;
     const std::chrono::nanoseconds target_frame_duration(16666667); // 60 FPS
-
-    bool frame_complete = false;
-    int ppu_cycles = 0;
-    int cpu_cycles = 0;
+    long frame_index = 0;
 
     while (g_signal_received == 0) {
         frame_start = clock::now();
 
         bus.input.update();
         
-        frame_complete = false;
-        while (!frame_complete) {
-            // 1. Run CPU (returns 2-7 cycles)
-            core.step();
-            
-            // 2. Sync other components to CPU time
-            cpu_cycles = core.last_cycles + bus.dma_cycles;
-            bus.dma_cycles = 0; // consumed
-            
-            bus.apu.step(cpu_cycles);
-
-            // 3. PPU runs at 3x CPU speed
-            ppu_cycles = cpu_cycles * 3;
-            frame_complete = bus.ppu.step(ppu_cycles);
-        }
+        // Run CPU, PPU and APU up to the next VBlank
+        const bool draw = frame_index++ % (frameskip + 1) == 0;
+        bus.setFrameSkip(!draw);
+        scheduler.runFrame();
 
         if (!renderer.handleEvents()) break;
-        renderer.draw(bus.ppu.getScreen());
+        if (draw) renderer.draw(bus.ppu.getScreen());
 
         // Frame Limiter
         frame_end = clock::now();
@@ -87,5 +96,9 @@ int main(int argc, char** argv) {
         }
     }
 
+    const APU::AudioStatus audio = bus.apu.audioStatus();
+    std::cout << "Audio: " << audio.latency_ms << " ms queued, rate x" << audio.rate_ratio << ", "
+              << audio.underruns << " underruns" << std::endl;
+
     return 0;
 }
\ No newline at end of file
@@ -1,10 +1,62 @@
 #pragma once
 #include <cstdint>
+#include <array>
 #include <vector>
 #include <string>
 #include <memory>
 #include "mapper.hpp"
 
+// One pattern table row decoded to 2-bit pixels, leftmost pixel in bits
+// 0-1, and the same row mirrored horizontally (for flipped sprites)
+struct PatternRow {
+    uint16_t normal = 0;
+    uint16_t flipped = 0;
+};
+
+inline PatternRow decodePatternRow(uint8_t lo, uint8_t hi) {
+    PatternRow row;
+    for (int i = 0; i < 8; ++i) {
+        uint16_t pixel = ((lo >> (7 - i)) & 0x01) | (((hi >> (7 - i)) & 0x01) << 1);
+        row.normal |= pixel << (2 * i);
+        row.flipped |= pixel << (2 * (7 - i));
+    }
+    return row;
+}
+
+// =============================================================
+// PATTERN TABLES
+// -----------------
+// $0000-$1FFF as the PPU sees it: CHR memory followed by a blank 1KB,
+// its decoded rows (tile * 8 + row) and the physical offset of each 1KB
+// PPU bank, with unmapped banks on the blank. The cartridge keeps its
+// view current; a deferred renderer works on copies (see deferred.hpp).
+// =============================================================
+struct PatternTables {
+    uint8_t* memory = nullptr;
+    PatternRow* rows = nullptr;
+    uint32_t size = 0;       // CHR bytes, blank 1KB excluded
+    bool writable = false;   // CHR-RAM
+    std::array<uint32_t, 8> bankOffset{};
+
+    uint8_t read(uint16_t addr) const { return memory[bankOffset[(addr >> 10) & 0x07] + (addr & 0x03FF)]; }
+
+    // Decoded row behind the pattern address addr (low bitplane). Same
+    // pixels read() returns for addr and addr + 8.
+    const PatternRow& row(uint16_t addr) const {
+        uint32_t offset = bankOffset[(addr >> 10) & 0x07] + (addr & 0x03F7);
+        return rows[((offset >> 4) << 3) | (offset & 0x07)];
+    }
+
+    // CHR-RAM write for views that own their memory (replay copies)
+    void write(uint16_t addr, uint8_t data) {
+        uint32_t offset = bankOffset[(addr >> 10) & 0x07] + (addr & 0x03FF);
+        if (!writable || offset >= size) return;
+        memory[offset] = data;
+        offset &= ~0x08u;
+        rows[((offset >> 4) << 3) | (offset & 0x07)] = decodePatternRow(memory[offset], memory[offset + 8]);
+    }
+};
+
 class Cartridge {
 public:
     Cartridge(const std::string& sFileName);
@@ -14,18 +66,39 @@ public:
     bool cpuRead(uint16_t addr, uint8_t &data);
     bool cpuWrite(uint16_t addr, uint8_t data);
 
+    // Host memory behind the 256-byte CPU page at addr, or nullptr if the
+    // access has to go through cpuRead()/cpuWrite(). Valid until the PRG
+    // map version changes.
+    const uint8_t* cpuReadPage(uint16_t addr);
+    uint8_t* cpuWritePage(uint16_t addr);
+
     // Communication with PPU Bus
     bool ppuRead(uint16_t addr, uint8_t &data);
     bool ppuWrite(uint16_t addr, uint8_t data);
+
+    // Direct view of the pattern tables, equivalent to ppuRead() for
+    // every address. Stays valid for the cartridge's lifetime.
+    const PatternTables& getPatternTables() const { return patternTables; }
     
     // Utility
     bool ImageValid();
     MirrorMode getMirroring();
+    uint8_t* ppuNametablePage(int table) { return pMapper->ppuMapNametable(table); }
     void reset();
     
     // Signals from Mapper
     bool getIRQ();
 
+    // Changes whenever bytes the CPU sees at $8000-$FFFF may have changed
+    uint32_t getPRGMapVersion() const { return pMapper->getPRGMapVersion() + nPRGWriteCount; }
+
+    // Changes whenever getMirroring() or ppuNametablePage() may have changed
+    uint32_t getMirrorVersion() const { return pMapper->getMirrorVersion(); }
+
+    // Changes whenever the pattern table banks have been remapped (the
+    // mapper CHR map version they follow)
+    uint32_t getCHRMapVersion() const { return nCHRMapVersion; }
+
 private:
     std::vector<uint8_t> vPRGMemory;
     std::vector<uint8_t> vCHRMemory;
@@ -33,8 +106,26 @@ private:
     uint8_t nMapperID = 0;
     uint8_t nPRGBanks = 0;
     uint8_t nCHRBanks = 0;
+    uint32_t nPRGWriteCount = 0;
 
     std::shared_ptr<Mapper> pMapper;
+
+    // =============================================================
+    // CHR ROW CACHE
+    // -----------------
+    // Every pattern row of CHR memory, decoded, indexed by physical
+    // address (tile * 8 + row). CHR-RAM writes re-decode their row, and
+    // the 1KB PPU bank table follows the mapper's CHR map version. Banks
+    // outside CHR memory point at a blank 1KB past the end of vCHRMemory,
+    // as ppuRead() returns 0 there.
+    // =============================================================
+    std::vector<PatternRow> vCHRDecoded;
+    PatternTables patternTables;
+    uint32_t nCHRSize = 0;
+    uint32_t nCHRMapVersion = 0;
+
+    void decodePatternRow(uint32_t offset);
+    void mapCHRBanks();
     
     bool bImageValid = false;
     MirrorMode hwMirror = MirrorMode::HORIZONTAL;
@@ -20,21 +20,40 @@ public:
     virtual bool cpuMapRead(uint16_t addr, uint32_t &mapped_addr, uint8_t &data) = 0;
     virtual bool cpuMapWrite(uint16_t addr, uint32_t &mapped_addr, uint8_t data = 0) = 0;
 
+    // Plain RAM the mapper exposes at addr (PRG-RAM), nullptr otherwise
+    virtual uint8_t* cpuMapRAM(uint16_t addr);
+
     // Transform PPU bus address to CHR ROM offset
     virtual bool ppuMapRead(uint16_t addr, uint32_t &mapped_addr) = 0;
     virtual bool ppuMapWrite(uint16_t addr, uint32_t &mapped_addr) = 0;
 
     virtual void reset();
     virtual MirrorMode getMirroringMode();
+
+    // Cartridge VRAM backing nametable 0-3 (four-screen boards), nullptr
+    // to use the console's 2KB as arranged by getMirroringMode()
+    virtual uint8_t* ppuMapNametable(int table);
     
     // IRQ Interface
     virtual bool getIRQ();
     virtual void clearIRQ();
     virtual void scanline(); // Optional helper for scanline counters
 
+    // Bumped whenever the CPU-visible PRG ROM mapping changes
+    uint32_t getPRGMapVersion() const { return nPRGMapVersion; }
+
+    // Bumped whenever the PPU-visible CHR bank mapping changes
+    uint32_t getCHRMapVersion() const { return nCHRMapVersion; }
+
+    // Bumped whenever the nametable arrangement may have changed
+    uint32_t getMirrorVersion() const { return nMirrorVersion; }
+
 protected:
     uint8_t nPRGBanks = 0;
     uint8_t nCHRBanks = 0;
+    uint32_t nPRGMapVersion = 0;
+    uint32_t nCHRMapVersion = 0;
+    uint32_t nMirrorVersion = 0;
 };
 
 // =============================================================
@@ -58,6 +77,7 @@ public:
     Mapper_001(uint8_t prgBanks, uint8_t chrBanks);
     bool cpuMapRead(uint16_t addr, uint32_t &mapped_addr, uint8_t &data) override;
     bool cpuMapWrite(uint16_t addr, uint32_t &mapped_addr, uint8_t data = 0) override;
+    uint8_t* cpuMapRAM(uint16_t addr) override;
     bool ppuMapRead(uint16_t addr, uint32_t &mapped_addr) override;
     bool ppuMapWrite(uint16_t addr, uint32_t &mapped_addr) override;
     void reset() override;
@@ -116,6 +136,7 @@ public:
     Mapper_004(uint8_t prgBanks, uint8_t chrBanks);
     bool cpuMapRead(uint16_t addr, uint32_t &mapped_addr, uint8_t &data) override;
     bool cpuMapWrite(uint16_t addr, uint32_t &mapped_addr, uint8_t data = 0) override;
+    uint8_t* cpuMapRAM(uint16_t addr) override;
     bool ppuMapRead(uint16_t addr, uint32_t &mapped_addr) override;
     bool ppuMapWrite(uint16_t addr, uint32_t &mapped_addr) override;
     void reset() override;
@@ -131,7 +152,7 @@ private:
     MirrorMode mirroring = MirrorMode::HORIZONTAL;
     
     std::array<uint32_t, 8> pRegister;
-    std::array<uint32_t, 4> pCHRBank;
+    std::array<uint32_t, 8> pCHRBank;
     std::array<uint32_t, 4> pPRGBank;
 
     bool bIRQActive = false;
@@ -73,6 +73,18 @@ Cartridge::Cartridge(const std::string& sFileName) {
                     break;
             }
 
+            nCHRSize = static_cast<uint32_t>(vCHRMemory.size());
+            vCHRMemory.resize(nCHRSize + 0x0400); // Blank 1KB for unmapped banks
+            vCHRDecoded.resize(vCHRMemory.size() / 2);
+            for (uint32_t tile = 0; tile < nCHRSize; tile += 16) {
+                for (uint32_t row = 0; row < 8; ++row) decodePatternRow(tile + row);
+            }
+            patternTables.memory = vCHRMemory.data();
+            patternTables.rows = vCHRDecoded.data();
+            patternTables.size = nCHRSize;
+            patternTables.writable = nCHRBanks == 0;
+            mapCHRBanks();
+
             bImageValid = true;
             ifs.close();
             
@@ -88,6 +100,7 @@ bool Cartridge::ImageValid() { return bImageValid; }
 void Cartridge::reset() {
     if (pMapper != nullptr) {
         pMapper->reset();
+        mapCHRBanks();
     }
 }
 
@@ -110,23 +123,44 @@ bool Cartridge::cpuRead(uint16_t addr, uint8_t &data) {
 
 bool Cartridge::cpuWrite(uint16_t addr, uint8_t data) {
     uint32_t mapped_addr = 0;
-    if (pMapper->cpuMapWrite(addr, mapped_addr, data)) {
+    bool handled = pMapper->cpuMapWrite(addr, mapped_addr, data);
+    if (pMapper->getCHRMapVersion() != nCHRMapVersion) mapCHRBanks();
+    if (handled) {
         if (mapped_addr == 0xFFFFFFFF) {
             // Mapper handled the write (e.g. RAM)
             return true;
         }
         if (mapped_addr < vPRGMemory.size()) {
             vPRGMemory[mapped_addr] = data;
+            nPRGWriteCount++;
         }
         return true;
     }
     return false;
 }
 
+const uint8_t* Cartridge::cpuReadPage(uint16_t addr) {
+    if (uint8_t* ram = pMapper->cpuMapRAM(addr)) return ram;
+
+    // Banks are at least 8KB, so a page never straddles two of them
+    uint32_t mapped_addr = 0;
+    uint8_t data = 0;
+    if (pMapper->cpuMapRead(addr, mapped_addr, data) && mapped_addr != 0xFFFFFFFF &&
+        mapped_addr + 0xFF < vPRGMemory.size()) {
+        return &vPRGMemory[mapped_addr];
+    }
+    return nullptr;
+}
+
+uint8_t* Cartridge::cpuWritePage(uint16_t addr) {
+    // PRG ROM writes stay on cpuWrite(): they are mapper register writes
+    return pMapper->cpuMapRAM(addr);
+}
+
 bool Cartridge::ppuRead(uint16_t addr, uint8_t &data) {
     uint32_t mapped_addr = 0;
     if (pMapper->ppuMapRead(addr, mapped_addr)) {
-        if (mapped_addr < vCHRMemory.size()) {
+        if (mapped_addr < nCHRSize) {
             data = vCHRMemory[mapped_addr];
         }
         return true;
@@ -137,14 +171,31 @@ bool Cartridge::ppuRead(uint16_t addr, uint8_t &data) {
 bool Cartridge::ppuWrite(uint16_t addr, uint8_t data) {
     uint32_t mapped_addr = 0;
     if (pMapper->ppuMapWrite(addr, mapped_addr)) {
-        if (mapped_addr < vCHRMemory.size()) {
+        if (mapped_addr < nCHRSize) {
             vCHRMemory[mapped_addr] = data;
+            decodePatternRow(mapped_addr);
         }
         return true;
     }
     return false;
 }
 
+// Rebuilds the cached row containing the CHR byte at offset
+void Cartridge::decodePatternRow(uint32_t offset) {
+    offset &= ~0x08u;
+    vCHRDecoded[((offset >> 4) << 3) | (offset & 0x07)] = ::decodePatternRow(vCHRMemory[offset], vCHRMemory[offset + 8]);
+}
+
+void Cartridge::mapCHRBanks() {
+    const uint32_t blank = nCHRSize;
+    for (int bank = 0; bank < 8; ++bank) {
+        uint32_t mapped_addr = 0;
+        bool mapped = pMapper->ppuMapRead(static_cast<uint16_t>(bank * 0x0400), mapped_addr);
+        patternTables.bankOffset[bank] = (mapped && mapped_addr + 0x03FF < blank) ? mapped_addr : blank;
+    }
+    nCHRMapVersion = pMapper->getCHRMapVersion();
+}
+
 MirrorMode Cartridge::getMirroring() {
     MirrorMode mode = pMapper->getMirroringMode();
     if (mode == MirrorMode::HARDWARE) {
@@ -5,7 +5,9 @@ Mapper::Mapper(uint8_t prgBanks, uint8_t chrBanks) : nPRGBanks(prgBanks), nCHRBa
 Mapper::~Mapper() = default;
 
 void Mapper::reset() {}
+uint8_t* Mapper::cpuMapRAM(uint16_t /*addr*/) { return nullptr; }
 MirrorMode Mapper::getMirroringMode() { return MirrorMode::HARDWARE; }
+uint8_t* Mapper::ppuMapNametable(int /*table*/) { return nullptr; }
 bool Mapper::getIRQ() { return false; }
 void Mapper::clearIRQ() {}
 void Mapper::scanline() {}
@@ -68,6 +70,9 @@ void Mapper_001::reset() {
     nCHRBankSelect4Hi = 0;
     nPRGBankSelect16Lo = 0;
     nPRGBankSelect16Hi = nPRGBanks - 1;
+    nPRGMapVersion++;
+    nCHRMapVersion++;
+    nMirrorVersion++;
 }
 
 bool Mapper_001::cpuMapRead(uint16_t addr, uint32_t &mapped_addr, uint8_t &data) {
@@ -107,6 +112,7 @@ bool Mapper_001::cpuMapWrite(uint16_t addr, uint32_t &mapped_addr, uint8_t data)
             nLoadRegister = 0x00;
             nLoadRegisterCount = 0;
             nControlRegister = nControlRegister | 0x0C;
+            nPRGMapVersion++;
         } else {
             // Serial Load
             nLoadRegister >>= 1;
@@ -119,6 +125,9 @@ bool Mapper_001::cpuMapWrite(uint16_t addr, uint32_t &mapped_addr, uint8_t data)
 
                 if (target == 0) { // 0x8000 - 0x9FFF: Control
                     nControlRegister = nLoadRegister & 0x1F;
+                    nPRGMapVersion++;
+                    nCHRMapVersion++;
+                    nMirrorVersion++;
                     switch (nControlRegister & 0x03) {
                         case 0: /* OneScreenLo */ break;
                         case 1: /* OneScreenHi */ break;
@@ -134,12 +143,14 @@ bool Mapper_001::cpuMapWrite(uint16_t addr, uint32_t &mapped_addr, uint8_t data)
                         // 8K CHR Bank Mode
                         nCHRBankSelect4Lo = nLoadRegister & 0x1E;
                     }
+                    nCHRMapVersion++;
                 }
                 else if (target == 2) { // 0xC000 - 0xDFFF: CHR Bank 1
                     if (nControlRegister & 0x10) {
                         // 4K CHR Bank Mode
                         nCHRBankSelect4Hi = nLoadRegister & 0x1F;
                     }
+                    nCHRMapVersion++;
                 }
                 else if (target == 3) { // 0xE000 - 0xFFFF: PRG Bank
                     uint8_t prgMode = (nControlRegister >> 2) & 0x03;
@@ -158,6 +169,7 @@ bool Mapper_001::cpuMapWrite(uint16_t addr, uint32_t &mapped_addr, uint8_t data)
                         nPRGBankSelect16Lo = nLoadRegister & 0x0F;
                         nPRGBankSelect16Hi = nPRGBanks - 1;
                     }
+                    nPRGMapVersion++;
                 }
 
                 // Reset Shift Register
@@ -169,6 +181,11 @@ bool Mapper_001::cpuMapWrite(uint16_t addr, uint32_t &mapped_addr, uint8_t data)
     return false; 
 }
 
+uint8_t* Mapper_001::cpuMapRAM(uint16_t addr) {
+    if (addr >= 0x6000 && addr <= 0x7FFF) return &vRAMStatic[addr & 0x1FFF];
+    return nullptr;
+}
+
 MirrorMode Mapper_001::getMirroringMode() {
     switch (nControlRegister & 0x03) {
         case 0: return MirrorMode::ONESCREEN_LO;
@@ -218,7 +235,7 @@ bool Mapper_001::ppuMapWrite(uint16_t addr, uint32_t &mapped_addr) {
 // =============================================================
 
 Mapper_002::Mapper_002(uint8_t prgBanks, uint8_t chrBanks) : Mapper(prgBanks, chrBanks) {}
-void Mapper_002::reset() { nPRGBankSelectLo = 0; }
+void Mapper_002::reset() { nPRGBankSelectLo = 0; nPRGMapVersion++; }
 
 bool Mapper_002::cpuMapRead(uint16_t addr, uint32_t &mapped_addr, uint8_t &data) {
     if (addr >= 0x8000 && addr <= 0xBFFF) {
@@ -237,6 +254,7 @@ bool Mapper_002::cpuMapRead(uint16_t addr, uint32_t &mapped_addr, uint8_t &data)
 bool Mapper_002::cpuMapWrite(uint16_t addr, uint32_t &mapped_addr, uint8_t data) {
     if (addr >= 0x8000) {
         nPRGBankSelectLo = data;
+        nPRGMapVersion++;
     }
     return false;
 }
@@ -264,7 +282,7 @@ bool Mapper_002::ppuMapWrite(uint16_t addr, uint32_t &mapped_addr) {
 // =============================================================
 
 Mapper_003::Mapper_003(uint8_t prgBanks, uint8_t chrBanks) : Mapper(prgBanks, chrBanks) {}
-void Mapper_003::reset() { nCHRBankSelect = 0; }
+void Mapper_003::reset() { nCHRBankSelect = 0; nCHRMapVersion++; }
 
 bool Mapper_003::cpuMapRead(uint16_t addr, uint32_t &mapped_addr, uint8_t &data) {
     if (addr >= 0x8000 && addr <= 0xFFFF) {
@@ -277,6 +295,7 @@ bool Mapper_003::cpuMapRead(uint16_t addr, uint32_t &mapped_addr, uint8_t &data)
 bool Mapper_003::cpuMapWrite(uint16_t addr, uint32_t &mapped_addr, uint8_t data) {
     if (addr >= 0x8000) {
         nCHRBankSelect = data & 0x03;
+        nCHRMapVersion++;
     }
     return false;
 }
@@ -321,6 +340,9 @@ void Mapper_004::reset() {
     pPRGBank[1] = 1;
     pPRGBank[2] = (nPRGBanks * 2) - 2;
     pPRGBank[3] = (nPRGBanks * 2) - 1;
+    nPRGMapVersion++;
+    nCHRMapVersion++;
+    nMirrorVersion++;
 }
 
 bool Mapper_004::cpuMapRead(uint16_t addr, uint32_t &mapped_addr, uint8_t &data) {
@@ -448,6 +470,9 @@ bool Mapper_004::cpuMapWrite(uint16_t addr, uint32_t &mapped_addr, uint8_t data)
             pCHRBank[6] = pRegister[4] * bank1k;
             pCHRBank[7] = pRegister[5] * bank1k;
         }
+
+        nPRGMapVersion++;
+        nCHRMapVersion++;
     }
 
     if (addr >= 0xA000 && addr <= 0xBFFF) {
@@ -455,6 +480,7 @@ bool Mapper_004::cpuMapWrite(uint16_t addr, uint32_t &mapped_addr, uint8_t data)
             // Mirroring
             if (data & 0x01) mirroring = MirrorMode::HORIZONTAL;
             else mirroring = MirrorMode::VERTICAL;
+            nMirrorVersion++;
         }
     }
 
@@ -478,6 +504,11 @@ bool Mapper_004::cpuMapWrite(uint16_t addr, uint32_t &mapped_addr, uint8_t data)
     return false;
 }
 
+uint8_t* Mapper_004::cpuMapRAM(uint16_t addr) {
+    if (addr >= 0x6000 && addr <= 0x7FFF) return &vRAMStatic[addr & 0x1FFF];
+    return nullptr;
+}
+
 bool Mapper_004::ppuMapRead(uint16_t addr, uint32_t &mapped_addr) {
     if (addr < 0x2000) {
         // Bank Mapping (1KB granularity)
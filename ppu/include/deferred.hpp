@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cstdint>
+#include <array>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "ppu.hpp"
+
+// =============================================================
+// DEFERRED RENDERING
+// -----------------
+// Moves pixel composition off the emulation thread. The attached PPU runs
+// as on skipped frames: timing, VBlank, sprite-0 hit and overflow stay
+// exact, no pixels are drawn. For each drawn frame it hands over a copy
+// of its state at the start of every band of lines, plus a log of what
+// changes the picture inside the band, timestamped by PPU dot: register
+// writes, the register reads with side effects ($2002 with the latch set,
+// $2007), OAM DMA, CHR bank switches and nametable remaps. CHR-RAM writes
+// are the logged $2007 writes that make them; each copy works on its own
+// CHR-RAM snapshot. Worker threads replay a band on its copy with
+// rendering on as soon as emulation has passed its last line, so the
+// bands render while the CPU runs the rest of the frame.
+//
+// Frames alternate between two buffers. getScreen() waits for the last
+// frame that reached line 240 and returns it; the reference stays valid
+// until the next frame is finished.
+// =============================================================
+
+class DeferredRenderer {
+    public:
+        // threads workers, lines 0-239 split into bands equal bands (the
+        // last one shorter if 240 does not divide)
+        explicit DeferredRenderer(int threads, int bands = 8);
+        ~DeferredRenderer();
+
+        DeferredRenderer(const DeferredRenderer&) = delete;
+        DeferredRenderer& operator=(const DeferredRenderer&) = delete;
+
+        const std::vector<uint32_t>& getScreen();
+        const IndexedFrame& getIndexedScreen();
+
+        // --- Called by the attached PPU ---
+        void lineStart(const PPU& ppu, uint64_t dot); // At (line, 0), lines 0-240
+        void logRegisterWrite(uint64_t dot, uint16_t address, uint8_t data);
+        void logRegisterRead(uint64_t dot, uint16_t address);
+        void logOAMDMA(uint64_t dot, const std::array<uint8_t, 256>& data);
+        void logPatternBanks(uint64_t dot, const std::array<uint32_t, 8>& offsets);
+        void logNametables(uint64_t dot, const std::array<uint8_t*, 4>& pages);
+
+    private:
+        enum class EventType : uint8_t { WRITE, READ, OAM_DMA, PATTERN_BANKS, NAMETABLES };
+
+        struct Event {
+            uint64_t dot;
+            EventType type;
+            uint8_t address;
+            uint8_t data;
+            uint32_t payload; // Offset into Band::payload (DMA page, bank or page table)
+        };
+
+        struct Band {
+            PPU ppu;
+            PatternTables patterns;
+            std::vector<uint8_t> chrMemory; // CHR-RAM snapshot
+            std::vector<PatternRow> chrRows;
+            const uint8_t* sourceNametables = nullptr; // Emulation PPU's tblName, for remaps
+            std::vector<Event> events;
+            std::vector<uint8_t> payload;
+            uint64_t end_dot = 0;
+            int buffer = 0;
+        };
+
+        struct Buffer {
+            std::vector<uint32_t> pixels = std::vector<uint32_t>(256 * 240, 0xFF000000);
+            IndexedFrame indexed;
+            int pending = 0; // Bands queued or rendering
+        };
+
+        int band_lines;
+        std::array<std::vector<std::unique_ptr<Band>>, 2> bands;
+        std::array<Buffer, 2> buffers;
+        Band* open = nullptr; // Band being logged
+        int frame_buffer = -1; // Buffer of the frame in progress
+        int latest = 0;        // Buffer of the last frame that reached line 240
+
+        std::vector<std::thread> workers;
+        std::deque<Band*> queue;
+        std::mutex mutex;
+        std::condition_variable work_ready;
+        std::condition_variable band_done;
+        bool stopping = false;
+
+        void beginBand(const PPU& ppu, int index, uint64_t dot);
+        void dispatch(Band& band, uint64_t end_dot);
+        void waitBuffer(int buffer);
+        void log(uint64_t dot, EventType type, uint8_t address, uint8_t data, const void* payload = nullptr, std::size_t size = 0);
+        void work();
+        static void replay(Band& band);
+};
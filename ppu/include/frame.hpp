@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <vector>
+#include "simd.hpp"
+
+// =============================================================
+// PALETTE-INDEX FRAMES
+// -----------------
+// A frame as the PPU produces it in indexed output mode: one 6-bit NES
+// colour per pixel (61KB instead of 245KB of ARGB), plus the colour mode
+// (see palette.hpp) each line was drawn with. Nothing is converted to
+// host pixels until convertFrame() is called, so frames that are never
+// displayed cost no colour work.
+//
+// Emphasis and grayscale are taken from the first pixel of each line; a
+// PPUMASK write that changes them mid-line shows from the next line in
+// this mode (ARGB output still applies them per pixel).
+// =============================================================
+
+struct IndexedFrame {
+    static constexpr int WIDTH = 256;
+    static constexpr int HEIGHT = 240;
+
+    std::vector<uint8_t> pixels = std::vector<uint8_t>(WIDTH * HEIGHT, 0x0F);
+    std::array<uint8_t, HEIGHT> modes{};
+};
+
+enum class PixelFormat {
+    ARGB8888, // uint32_t 0xAARRGGBB, as PPU::getScreen()
+    RGBA8888, // uint32_t 0xRRGGBBAA
+    RGB565,   // uint16_t
+    GRAY8     // uint8_t luminance
+};
+
+std::size_t bytesPerPixel(PixelFormat format);
+
+// Writes the frame to out (WIDTH * HEIGHT * bytesPerPixel(format) bytes),
+// using AVX2 or SSE2 kernels when the host has them
+void convertFrame(const IndexedFrame& frame, PixelFormat format, void* out);
+void convertFrame(const IndexedFrame& frame, PixelFormat format, void* out, SimdLevel level); // That level's kernel
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstdint>
+#include <array>
+
+// =============================================================
+// NES COLOURS
+// -----------------
+// The 64-entry system palette and the PPUMASK grayscale and emphasis
+// effects, shared by the PPU and the palette-index frame converter.
+// =============================================================
+
+inline constexpr std::array<uint32_t, 64> systemPalette = {{
+    0xFF7C7C7C, 0xFF0000FC, 0xFF0000BC, 0xFF4428BC, 0xFF940084, 0xFFA80020, 0xFFA81000, 0xFF881400,
+    0xFF503000, 0xFF007800, 0xFF006800, 0xFF005800, 0xFF004058, 0xFF000000, 0xFF000000, 0xFF000000,
+    0xFFBCBCBC, 0xFF0078F8, 0xFF0058F8, 0xFF6844FC, 0xFFD800CC, 0xFFE40058, 0xFFF83800, 0xFFE45C10,
+    0xFFAC7C00, 0xFF00B800, 0xFF00A800, 0xFF00A844, 0xFF008888, 0xFF000000, 0xFF000000, 0xFF000000,
+    0xFFF8F8F8, 0xFF3CBCFC, 0xFF6888FC, 0xFF9878F8, 0xFFF878F8, 0xFFF85898, 0xFFF87858, 0xFFFCA044,
+    0xFFF8B800, 0xFFB8F818, 0xFF58D854, 0xFF58F898, 0xFF00E8D8, 0xFF787878, 0xFF000000, 0xFF000000,
+    0xFFFCFCFC, 0xFFA4E4FC, 0xFFB8B8F8, 0xFFD8B8F8, 0xFFF8B8F8, 0xFFF8A4C0, 0xFFF0D0B0, 0xFFFCE0A8,
+    0xFFF8D878, 0xFFD8F878, 0xFFB8F8B8, 0xFFB8F8D8, 0xFF00FCFC, 0xFFF8D8F8, 0xFF000000, 0xFF000000
+}};
+
+inline constexpr uint32_t applyGrayscale(uint32_t color) {
+    uint8_t r = (color >> 16) & 0xFF;
+    uint8_t g = (color >> 8) & 0xFF;
+    uint8_t b = color & 0xFF;
+    uint8_t gray = static_cast<uint8_t>(0.299 * r + 0.587 * g + 0.114 * b);
+    return 0xFF000000 | (gray << 16) | (gray << 8) | gray;
+}
+
+inline constexpr uint32_t applyEmphasis(uint32_t color, uint8_t emphasis) {
+    if (emphasis == 0) return color;
+    
+    uint8_t r = (color >> 16) & 0xFF;
+    uint8_t g = (color >> 8) & 0xFF;
+    uint8_t b = color & 0xFF;
+    
+    if (!(emphasis & 0x01)) r = r * 3 / 4;
+    if (!(emphasis & 0x02)) g = g * 3 / 4;
+    if (!(emphasis & 0x04)) b = b * 3 / 4;
+    
+    return 0xFF000000 | (r << 16) | (g << 8) | b;
+}
+
+// Every colour the PPU can output, indexed by colour mode (PPUMASK's
+// emphasis bits 7-5 as bits 2-0, its grayscale bit 0 as bit 3), then by
+// the 6-bit palette entry. Built at compile time.
+inline constexpr std::array<std::array<uint32_t, 64>, 16> colorTable = [] {
+    std::array<std::array<uint32_t, 64>, 16> table{};
+    for (int mode = 0; mode < 16; ++mode) {
+        for (int entry = 0; entry < 64; ++entry) {
+            uint32_t color = systemPalette[entry];
+            if (mode & 0x08) color = applyGrayscale(color);
+            table[mode][entry] = applyEmphasis(color, mode & 0x07);
+        }
+    }
+    return table;
+}();
+
+// Colour mode (colorTable row) for a PPUMASK value
+inline constexpr uint8_t colorMode(uint8_t mask) {
+    return ((mask >> 5) & 0x07) | ((mask & 0x01) << 3);
+}
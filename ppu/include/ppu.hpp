@@ -5,6 +5,15 @@
 #include <array>
 #include <memory>
 #include "cartridge.hpp"
+#include "frame.hpp"
+#include "simd.hpp"
+
+class DeferredRenderer;
+
+// Sprites whose Y byte puts them on the line at the given sprite height,
+// as a bitmask (bit i = sprite i), using that level's kernel. y holds 64
+// bytes, 32-byte aligned like PPU::oamFields.
+uint64_t spritesInRange(const uint8_t* y, int line, int height, SimdLevel level);
 
 class PPU {
     public:
@@ -20,6 +29,8 @@ class PPU {
 
         // Connectivity
         void connectCartridge(const std::shared_ptr<Cartridge>& cartridge);
+        void mapNametables(); // After the cartridge's mirror version changes
+        void chrBanksSwitched(); // After the cartridge's CHR map version changes
         void reset();
 
         // CPU Interface
@@ -28,9 +39,40 @@ class PPU {
         
         // System Timing
         bool step(int cycles);
+        bool catchUp(uint64_t dot) { return dot > dot_clock && step(static_cast<int>(dot - dot_clock)); }
+        uint64_t getDotClock() const { return dot_clock; } // Dots run since power-on
+        int dotsUntilVBlank() const; // Dots step() runs before VBlank (and NMI) starts
+        int dotsUntilStatusChange() const; // Dots before any PPUSTATUS bit can be set or cleared
+        uint8_t peekStatus() const { return ppustatus; } // $2002 without the read side effects
+        void markLineDirty() { line_dirty = sprite_line_stale = true; } // Mapper changed CHR banks or mirroring
         
-        // Interface for Renderer
+        // Interface for Renderer. In INDEXED mode the PPU fills the
+        // palette-index frame instead of the ARGB screen; convert it with
+        // convertFrame() (frame.hpp) when it is actually needed.
+        enum class OutputMode { ARGB, INDEXED };
+        void setOutputMode(OutputMode mode) { output = mode; }
+        OutputMode getOutputMode() const { return output; }
         const std::vector<uint32_t>& getScreen() const;
+        const IndexedFrame& getIndexedScreen() const;
+
+        // Frame skip: while set, lines are not composed and the screen
+        // keeps the last drawn frame. Everything a game can observe stays
+        // exact (VBlank/NMI, sprite-0 hit from sprite 0's own pixels,
+        // overflow, fetches). Applies from the next dot; set it between
+        // frames.
+        void setFrameSkip(bool skip) {
+            if (skip != skip_frame) sprite_line_stale = true;
+            skip_frame = skip;
+            skip_pixels = skip_frame || deferred;
+        }
+        bool getFrameSkip() const { return skip_frame; }
+
+        // Deferred rendering (deferred.hpp): while attached, this PPU
+        // composes no pixels, as on skipped frames, and hands the renderer
+        // what it needs to draw each frame on its worker threads. The
+        // screen getters then return the renderer's frames. Attach or
+        // detach (nullptr) between frames.
+        void setDeferredRenderer(DeferredRenderer* renderer);
 
         // Interrupt Signal
         bool nmiOccurred = false;
@@ -40,21 +82,35 @@ class PPU {
         void startOAMDMA(const std::array<uint8_t, 256>& data);
 
     private:
+        friend class DeferredRenderer;
+
         std::shared_ptr<Cartridge> cart;
+        const PatternTables* patterns = nullptr; // The cartridge's, or a replay copy's
+        PatternTables* patternCopy = nullptr;    // Replay copies: CHR-RAM writes land here
+        DeferredRenderer* deferred = nullptr;
 
         bool suppress_vbl = false;
-        uint32_t applyGrayscale(uint32_t color);
-        uint32_t applyEmphasis(uint32_t color);
         
         // --- Memory ---
         std::array<uint8_t, 2048> tblName;
+        std::array<uint8_t*, 4> nametablePages; // $2000, $2400, $2800, $2C00
         std::array<uint8_t, 32> tblPalette;
         // chrROM is removed; access goes through 'cart'
         std::array<uint8_t, 256> oamData;
+        // OAM again by field (Y, tile, attribute, X: one row of 64 each),
+        // for evaluateSprites(). Every OAM write goes to both.
+        alignas(32) std::array<std::array<uint8_t, 64>, 4> oamFields{};
 
         // --- Screen Buffer ---
         std::vector<uint32_t> pixels;
-        static const std::array<uint32_t, 64> systemPalette;
+        IndexedFrame indexedFrame;
+        uint32_t* screen = nullptr;     // Where composed pixels go: pixels, or a
+        IndexedFrame* indexed = nullptr; // deferred renderer's frame for replays
+        OutputMode output = OutputMode::ARGB;
+        bool skip_frame = false;
+        bool skip_pixels = false; // Skipped frame or deferred rendering
+        std::array<uint32_t, 32> resolvedPalette{}; // ARGB per palette RAM index, with mask effects
+        std::array<uint8_t, 32> resolvedEntry{};    // System palette entry per palette RAM index
 
         // --- Registers ---
         uint8_t ppuctrl = 0;   // $2000
@@ -100,6 +156,17 @@ class PPU {
         };
         
         std::vector<ObjectAttrEntry> spriteScanline; 
+
+        // Sprite pixels of the line being drawn, one per x
+        struct SpritePixel {
+            uint8_t pixel = 0;
+            uint8_t palette = 0;
+            bool priority = false;
+            bool isZero = false;
+        };
+
+        std::array<SpritePixel, 256> spriteLine{};
+        bool sprite_line_stale = false;
         uint8_t sprite_count = 0;
         bool bSpriteZeroHitPossible = false;
         bool bSpriteZeroBeingRendered = false;
@@ -108,13 +175,21 @@ class PPU {
         int16_t cycle = 0;
         int16_t scanline = 0; 
         uint64_t frame_count = 0;
+        uint64_t dot_clock = 0; // Timestamp for catch-up, not reset with the PPU
         bool frame_complete = false;
+        bool line_dirty = false; // Current line saw a write and stays on the dot path
 
         // --- Internal Helpers ---
+        void writeOAM(uint8_t address, uint8_t data) {
+            oamData[address] = data;
+            oamFields[address & 0x03][address >> 2] = data;
+        }
+        void copyState(const PPU& other); // Everything but the frame buffers and connections
+        void setNametablePages(const std::array<uint8_t*, 4>& pages, const uint8_t* source);
         uint8_t ppuRead(uint16_t address);
         void ppuWrite(uint16_t address, uint8_t data);
         
-        uint32_t getColorFromPaletteRam(uint8_t palette, uint8_t pixel);
+        void resolvePalette();
         
         void incrementScrollX();
         void incrementScrollY();
@@ -122,8 +197,16 @@ class PPU {
         void transferAddressY();
         
         void loadBackgroundShifters();
-        void updateShifters();
+        void updateShifters(int dots = 1);
+        void fetchBackgroundTile();
+        void runTileGroup(bool render);
         
         void renderPixel();
+        void renderScanline();
+        void renderBackground(int x, uint16_t bit_mux);
+        void composePixel(int x);
+        void checkSpriteZeroHit(int x);
+        int idleDotsAhead() const;
         void evaluateSprites(); 
+        void renderSpriteLine(int line);
 };
\ No newline at end of file
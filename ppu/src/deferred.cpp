@@ -0,0 +1,195 @@
+#include "deferred.hpp"
+#include <algorithm>
+#include <cstring>
+
+DeferredRenderer::DeferredRenderer(int threads, int bands_per_frame) {
+    bands_per_frame = std::clamp(bands_per_frame, 1, 240);
+    band_lines = (240 + bands_per_frame - 1) / bands_per_frame;
+    for (auto& frame_bands : bands) {
+        for (int line = 0; line < 240; line += band_lines) frame_bands.push_back(std::make_unique<Band>());
+    }
+
+    for (int i = 0; i < std::max(1, threads); ++i) workers.emplace_back(&DeferredRenderer::work, this);
+}
+
+DeferredRenderer::~DeferredRenderer() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    work_ready.notify_all();
+    for (auto& worker : workers) worker.join();
+}
+
+const std::vector<uint32_t>& DeferredRenderer::getScreen() {
+    waitBuffer(latest);
+    return buffers[latest].pixels;
+}
+
+const IndexedFrame& DeferredRenderer::getIndexedScreen() {
+    waitBuffer(latest);
+    return buffers[latest].indexed;
+}
+
+// =============================================================
+// EMULATION THREAD
+// =============================================================
+
+// Band boundaries: close the band being logged, then open the next one.
+// A frame is drawn into the buffer not holding the latest frame, once
+// that buffer's previous bands are done.
+void DeferredRenderer::lineStart(const PPU& ppu, uint64_t dot) {
+    const int line = ppu.scanline;
+    if (line % band_lines != 0 && line != 240) return;
+
+    if (open) {
+        dispatch(*open, dot);
+        open = nullptr;
+    }
+
+    if (line == 0) {
+        frame_buffer = ppu.skip_frame ? -1 : latest ^ 1;
+        if (frame_buffer >= 0) waitBuffer(frame_buffer);
+    }
+    if (frame_buffer < 0) return;
+
+    if (line == 240) {
+        latest = frame_buffer;
+        frame_buffer = -1;
+        return;
+    }
+    beginBand(ppu, line / band_lines, dot);
+}
+
+void DeferredRenderer::beginBand(const PPU& ppu, int index, uint64_t dot) {
+    Band& band = *bands[frame_buffer][index];
+    band.ppu.copyState(ppu);
+    band.ppu.dot_clock = dot;
+
+    // CHR ROM is shared; CHR-RAM is copied as it is at the band's start
+    band.patterns = *ppu.patterns;
+    if (band.patterns.writable) {
+        const uint32_t bytes = band.patterns.size + 0x0400;
+        band.chrMemory.assign(band.patterns.memory, band.patterns.memory + bytes);
+        band.chrRows.assign(band.patterns.rows, band.patterns.rows + bytes / 2);
+        band.patterns.memory = band.chrMemory.data();
+        band.patterns.rows = band.chrRows.data();
+    }
+    band.ppu.patterns = &band.patterns;
+    band.ppu.patternCopy = band.patterns.writable ? &band.patterns : nullptr;
+
+    Buffer& buffer = buffers[frame_buffer];
+    band.ppu.screen = buffer.pixels.data();
+    band.ppu.indexed = &buffer.indexed;
+    band.sourceNametables = ppu.tblName.data();
+    band.events.clear();
+    band.payload.clear();
+    band.buffer = frame_buffer;
+    open = &band;
+}
+
+void DeferredRenderer::dispatch(Band& band, uint64_t end_dot) {
+    band.end_dot = end_dot;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        buffers[band.buffer].pending++;
+        queue.push_back(&band);
+    }
+    work_ready.notify_one();
+}
+
+void DeferredRenderer::waitBuffer(int buffer) {
+    std::unique_lock<std::mutex> lock(mutex);
+    band_done.wait(lock, [&] { return buffers[buffer].pending == 0; });
+}
+
+void DeferredRenderer::log(uint64_t dot, EventType type, uint8_t address, uint8_t data, const void* payload, std::size_t size) {
+    if (!open) return;
+    const auto offset = static_cast<uint32_t>(open->payload.size());
+    if (size) {
+        const auto* bytes = static_cast<const uint8_t*>(payload);
+        open->payload.insert(open->payload.end(), bytes, bytes + size);
+    }
+    open->events.push_back(Event{dot, type, address, data, offset});
+}
+
+void DeferredRenderer::logRegisterWrite(uint64_t dot, uint16_t address, uint8_t data) {
+    log(dot, EventType::WRITE, static_cast<uint8_t>(address), data);
+}
+
+void DeferredRenderer::logRegisterRead(uint64_t dot, uint16_t address) {
+    log(dot, EventType::READ, static_cast<uint8_t>(address), 0);
+}
+
+void DeferredRenderer::logOAMDMA(uint64_t dot, const std::array<uint8_t, 256>& data) {
+    log(dot, EventType::OAM_DMA, 0, 0, data.data(), data.size());
+}
+
+void DeferredRenderer::logPatternBanks(uint64_t dot, const std::array<uint32_t, 8>& offsets) {
+    log(dot, EventType::PATTERN_BANKS, 0, 0, offsets.data(), sizeof(offsets));
+}
+
+void DeferredRenderer::logNametables(uint64_t dot, const std::array<uint8_t*, 4>& pages) {
+    log(dot, EventType::NAMETABLES, 0, 0, pages.data(), sizeof(pages));
+}
+
+// =============================================================
+// WORKERS
+// =============================================================
+
+void DeferredRenderer::work() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        work_ready.wait(lock, [&] { return stopping || !queue.empty(); });
+        if (queue.empty()) return;
+        Band* band = queue.front();
+        queue.pop_front();
+
+        lock.unlock();
+        replay(*band);
+        lock.lock();
+
+        buffers[band->buffer].pending--;
+        band_done.notify_all();
+    }
+}
+
+// Runs the band's copy from its first line to the next band's, applying
+// each logged event at the dot it happened on the emulation thread
+void DeferredRenderer::replay(Band& band) {
+    PPU& ppu = band.ppu;
+    auto runTo = [&](uint64_t dot) {
+        if (dot > ppu.dot_clock) ppu.step(static_cast<int>(dot - ppu.dot_clock));
+    };
+
+    for (const Event& event : band.events) {
+        runTo(event.dot);
+        const uint8_t* payload = band.payload.data() + event.payload;
+        switch (event.type) {
+            case EventType::WRITE:
+                ppu.cpuWrite(event.address, event.data);
+                break;
+            case EventType::READ:
+                ppu.cpuRead(event.address);
+                break;
+            case EventType::OAM_DMA: {
+                std::array<uint8_t, 256> page;
+                std::memcpy(page.data(), payload, page.size());
+                ppu.startOAMDMA(page);
+                break;
+            }
+            case EventType::PATTERN_BANKS:
+                std::memcpy(band.patterns.bankOffset.data(), payload, sizeof(band.patterns.bankOffset));
+                ppu.markLineDirty();
+                break;
+            case EventType::NAMETABLES: {
+                std::array<uint8_t*, 4> pages;
+                std::memcpy(pages.data(), payload, sizeof(pages));
+                ppu.setNametablePages(pages, band.sourceNametables);
+                ppu.markLineDirty();
+                break;
+            }
+        }
+    }
+    runTo(band.end_dot);
+}
@@ -0,0 +1,168 @@
+#include "frame.hpp"
+#include "palette.hpp"
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define FRAME_SIMD 1
+#include <immintrin.h>
+#endif
+
+std::size_t bytesPerPixel(PixelFormat format) {
+    switch (format) {
+        case PixelFormat::ARGB8888:
+        case PixelFormat::RGBA8888: return 4;
+        case PixelFormat::RGB565:   return 2;
+        case PixelFormat::GRAY8:    return 1;
+    }
+    return 4;
+}
+
+// One colorTable entry in the target format, widened to 32 bits
+static uint32_t encodeColor(uint32_t argb, PixelFormat format) {
+    uint32_t r = (argb >> 16) & 0xFF;
+    uint32_t g = (argb >> 8) & 0xFF;
+    uint32_t b = argb & 0xFF;
+    switch (format) {
+        case PixelFormat::ARGB8888: return argb;
+        case PixelFormat::RGBA8888: return (argb << 8) | (argb >> 24);
+        case PixelFormat::RGB565:   return ((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3);
+        case PixelFormat::GRAY8:    return (r * 77 + g * 150 + b * 29) >> 8;
+    }
+    return argb;
+}
+
+// =============================================================
+// LINE KERNELS
+// -----------------
+// Each maps count 6-bit colours through a 64-entry lookup table of
+// encoded colours and stores them at the format's width. count is a
+// multiple of 32 (a line is 256 pixels).
+// =============================================================
+
+using LineKernel = void (*)(const uint8_t* src, const uint32_t* lut, int count, std::size_t bytes, void* dst);
+
+static void convertLineScalar(const uint8_t* src, const uint32_t* lut, int count, std::size_t bytes, void* dst) {
+    if (bytes == 4) {
+        uint32_t* out = static_cast<uint32_t*>(dst);
+        for (int i = 0; i < count; ++i) out[i] = lut[src[i] & 0x3F];
+    } else if (bytes == 2) {
+        uint16_t* out = static_cast<uint16_t*>(dst);
+        for (int i = 0; i < count; ++i) out[i] = static_cast<uint16_t>(lut[src[i] & 0x3F]);
+    } else {
+        uint8_t* out = static_cast<uint8_t*>(dst);
+        for (int i = 0; i < count; ++i) out[i] = static_cast<uint8_t>(lut[src[i] & 0x3F]);
+    }
+}
+
+#ifdef FRAME_SIMD
+
+// SSE2 has no gather: four table loads per vector, then vector packing
+// and full-width stores
+static inline __m128i lookup4(const uint8_t* src, const uint32_t* lut) {
+    return _mm_setr_epi32(static_cast<int>(lut[src[0] & 0x3F]), static_cast<int>(lut[src[1] & 0x3F]),
+                          static_cast<int>(lut[src[2] & 0x3F]), static_cast<int>(lut[src[3] & 0x3F]));
+}
+
+static void convertLineSSE2(const uint8_t* src, const uint32_t* lut, int count, std::size_t bytes, void* dst) {
+    uint8_t* out = static_cast<uint8_t*>(dst);
+    if (bytes == 4) {
+        for (int i = 0; i < count; i += 4) {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i * 4), lookup4(src + i, lut));
+        }
+    } else if (bytes == 2) {
+        // packs_epi32 saturates signed, so bias the 16-bit values into range
+        const __m128i bias32 = _mm_set1_epi32(0x8000);
+        const __m128i bias16 = _mm_set1_epi16(static_cast<short>(0x8000));
+        for (int i = 0; i < count; i += 8) {
+            __m128i lo = _mm_sub_epi32(lookup4(src + i, lut), bias32);
+            __m128i hi = _mm_sub_epi32(lookup4(src + i + 4, lut), bias32);
+            __m128i packed = _mm_xor_si128(_mm_packs_epi32(lo, hi), bias16);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i * 2), packed);
+        }
+    } else {
+        for (int i = 0; i < count; i += 16) {
+            __m128i a = _mm_packs_epi32(lookup4(src + i, lut), lookup4(src + i + 4, lut));
+            __m128i b = _mm_packs_epi32(lookup4(src + i + 8, lut), lookup4(src + i + 12, lut));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_packus_epi16(a, b));
+        }
+    }
+}
+
+// AVX2: hardware gathers of eight entries, packs fixed up across lanes
+__attribute__((target("avx2")))
+static inline __m256i lookup8(const uint8_t* src, const uint32_t* lut) {
+    __m128i bytes = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(src));
+    __m256i index = _mm256_and_si256(_mm256_cvtepu8_epi32(bytes), _mm256_set1_epi32(0x3F));
+    return _mm256_i32gather_epi32(reinterpret_cast<const int*>(lut), index, 4);
+}
+
+__attribute__((target("avx2")))
+static void convertLineAVX2(const uint8_t* src, const uint32_t* lut, int count, std::size_t bytes, void* dst) {
+    uint8_t* out = static_cast<uint8_t*>(dst);
+    if (bytes == 4) {
+        for (int i = 0; i < count; i += 8) {
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i * 4), lookup8(src + i, lut));
+        }
+    } else if (bytes == 2) {
+        for (int i = 0; i < count; i += 16) {
+            __m256i packed = _mm256_packus_epi32(lookup8(src + i, lut), lookup8(src + i + 8, lut));
+            packed = _mm256_permute4x64_epi64(packed, 0xD8);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i * 2), packed);
+        }
+    } else {
+        const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+        for (int i = 0; i < count; i += 32) {
+            __m256i a = _mm256_packus_epi32(lookup8(src + i, lut), lookup8(src + i + 8, lut));
+            __m256i b = _mm256_packus_epi32(lookup8(src + i + 16, lut), lookup8(src + i + 24, lut));
+            __m256i packed = _mm256_permutevar8x32_epi32(_mm256_packus_epi16(a, b), order);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), packed);
+        }
+    }
+}
+
+#endif
+
+static LineKernel selectKernel() {
+#ifdef FRAME_SIMD
+    if (__builtin_cpu_supports("avx2")) return convertLineAVX2;
+    return convertLineSSE2; // Part of x86-64
+#else
+    return convertLineScalar;
+#endif
+}
+
+static LineKernel levelKernel(SimdLevel level) {
+#ifdef FRAME_SIMD
+    if (level == SimdLevel::AVX2) return convertLineAVX2;
+    if (level == SimdLevel::SSE2) return convertLineSSE2;
+#endif
+    (void)level;
+    return convertLineScalar;
+}
+
+static void convertFrameWith(LineKernel kernel, const IndexedFrame& frame, PixelFormat format, void* out) {
+    const std::size_t bytes = bytesPerPixel(format);
+
+    // Lookup tables for the colour modes this frame uses, built once each
+    std::array<std::array<uint32_t, 64>, 16> luts;
+    uint16_t built = 0;
+
+    uint8_t* dst = static_cast<uint8_t*>(out);
+    for (int line = 0; line < IndexedFrame::HEIGHT; ++line) {
+        const uint8_t mode = frame.modes[line] & 0x0F;
+        if (!(built & (1 << mode))) {
+            for (int entry = 0; entry < 64; ++entry) luts[mode][entry] = encodeColor(colorTable[mode][entry], format);
+            built |= 1 << mode;
+        }
+        kernel(&frame.pixels[line * IndexedFrame::WIDTH], luts[mode].data(), IndexedFrame::WIDTH, bytes,
+               dst + line * IndexedFrame::WIDTH * bytes);
+    }
+}
+
+void convertFrame(const IndexedFrame& frame, PixelFormat format, void* out) {
+    static const LineKernel kernel = selectKernel();
+    convertFrameWith(kernel, frame, format, out);
+}
+
+void convertFrame(const IndexedFrame& frame, PixelFormat format, void* out, SimdLevel level) {
+    convertFrameWith(levelKernel(level), frame, format, out);
+}
@@ -1,24 +1,23 @@
 #include "ppu.hpp"
+#include "palette.hpp"
+#include "deferred.hpp"
 #include <cstring>
 #include <algorithm>
 
-const std::array<uint32_t, 64> PPU::systemPalette = {{
-    0xFF7C7C7C, 0xFF0000FC, 0xFF0000BC, 0xFF4428BC, 0xFF940084, 0xFFA80020, 0xFFA81000, 0xFF881400,
-    0xFF503000, 0xFF007800, 0xFF006800, 0xFF005800, 0xFF004058, 0xFF000000, 0xFF000000, 0xFF000000,
-    0xFFBCBCBC, 0xFF0078F8, 0xFF0058F8, 0xFF6844FC, 0xFFD800CC, 0xFFE40058, 0xFFF83800, 0xFFE45C10,
-    0xFFAC7C00, 0xFF00B800, 0xFF00A800, 0xFF00A844, 0xFF008888, 0xFF000000, 0xFF000000, 0xFF000000,
-    0xFFF8F8F8, 0xFF3CBCFC, 0xFF6888FC, 0xFF9878F8, 0xFFF878F8, 0xFFF85898, 0xFFF87858, 0xFFFCA044,
-    0xFFF8B800, 0xFFB8F818, 0xFF58D854, 0xFF58F898, 0xFF00E8D8, 0xFF787878, 0xFF000000, 0xFF000000,
-    0xFFFCFCFC, 0xFFA4E4FC, 0xFFB8B8F8, 0xFFD8B8F8, 0xFFF8B8F8, 0xFFF8A4C0, 0xFFF0D0B0, 0xFFFCE0A8,
-    0xFFF8D878, 0xFFD8F878, 0xFFB8F8B8, 0xFFB8F8D8, 0xFF00FCFC, 0xFFF8D8F8, 0xFF000000, 0xFF000000
-}};
+#if defined(__x86_64__) && defined(__GNUC__)
+#define PPU_SIMD 1
+#include <immintrin.h>
+#endif
 
 PPU::PPU() {
     tblName.fill(0);
+    for (int table = 0; table < 4; ++table) nametablePages[table] = &tblName[(table & 0x01) * 0x0400];
     tblPalette.fill(0);
     oamData.fill(0);
     pixels.resize(256 * 240);
     pixels.assign(256 * 240, 0xFF000000);
+    screen = pixels.data();
+    indexed = &indexedFrame;
     spriteScanline.reserve(8);
     reset();
 }
@@ -27,6 +26,7 @@ PPU::~PPU() = default;
 
 void PPU::connectCartridge(const std::shared_ptr<Cartridge>& cartridge) {
     this->cart = cartridge;
+    patterns = cart ? &cart->getPatternTables() : nullptr;
 }
 
 void PPU::reset() {
@@ -37,13 +37,16 @@ void PPU::reset() {
     v_ram_addr = 0;
     t_ram_addr = 0;
     ppu_data_buffer = 0;
+    resolvePalette();
     scanline = 0;
     cycle = 0;
     frame_count = 0;
     frame_complete = false;
+    if (deferred) deferred->lineStart(*this, dot_clock);
 }
 
-const std::vector<uint32_t>& PPU::getScreen() const { return pixels; }
+const std::vector<uint32_t>& PPU::getScreen() const { return deferred ? deferred->getScreen() : pixels; }
+const IndexedFrame& PPU::getIndexedScreen() const { return deferred ? deferred->getIndexedScreen() : indexedFrame; }
 const std::array<uint8_t, 256>& PPU::getOAM() const { return oamData; }
 
 // =============================================================
@@ -52,77 +55,66 @@ const std::array<uint8_t, 256>& PPU::getOAM() const { return oamData; }
 
 uint8_t PPU::ppuRead(uint16_t address) {
     address &= 0x3FFF;
-    uint8_t data = 0;
 
     // 1. Cartridge (Pattern Tables $0000-$1FFF)
-    if (cart->ppuRead(address, data)) {
-        return data;
+    if (address < 0x2000) {
+        return patterns->read(address);
     }
     
     // 2. Nametables ($2000-$3EFF)
-    else if (address >= 0x2000 && address < 0x3F00) { 
-        address &= 0x0FFF;
-        
-        // Dynamic Mirroring from Cartridge
-        MirrorMode mode = cart->getMirroring();
-        
-        if (mode == MirrorMode::VERTICAL) {
-            return tblName[address & 0x07FF];
-        } 
-        else if (mode == MirrorMode::HORIZONTAL) {
-            if (address & 0x0800) return tblName[0x0400 + (address & 0x03FF)]; 
-            else return tblName[address & 0x03FF];
-        }
-        else if (mode == MirrorMode::ONESCREEN_LO) {
-            return tblName[address & 0x03FF];
-        }
-        else if (mode == MirrorMode::ONESCREEN_HI) {
-            return tblName[0x0400 + (address & 0x03FF)];
-        }
+    else if (address < 0x3F00) { 
+        return nametablePages[(address >> 10) & 0x03][address & 0x03FF];
     }
     // 3. Palette ($3F00-$3FFF)
-    else if (address >= 0x3F00) { 
+    else { 
         address &= 0x001F;
         if ((address & 0x03) == 0) address &= 0x0F; // Mirror bg colors
         return tblPalette[address];
     }
-    
-    return 0;
 }
 
 void PPU::ppuWrite(uint16_t address, uint8_t data) {
     address &= 0x3FFF;
     
     // 1. Cartridge (CHR RAM if present)
-    if (cart->ppuWrite(address, data)) {
-        return;
+    if (address < 0x2000) {
+        if (cart) cart->ppuWrite(address, data);
+        else if (patternCopy) patternCopy->write(address, data);
     }
     // 2. Nametables
-    else if (address >= 0x2000 && address < 0x3F00) {
-        address &= 0x0FFF;
-        
-        MirrorMode mode = cart->getMirroring();
-        
-        if (mode == MirrorMode::VERTICAL) {
-            tblName[address & 0x07FF] = data;
-        } 
-        else if (mode == MirrorMode::HORIZONTAL) {
-            if (address & 0x0800) tblName[0x0400 + (address & 0x03FF)] = data; 
-            else tblName[address & 0x03FF] = data;
-        }
-        else if (mode == MirrorMode::ONESCREEN_LO) {
-            tblName[address & 0x03FF] = data;
-        }
-        else if (mode == MirrorMode::ONESCREEN_HI) {
-            tblName[0x0400 + (address & 0x03FF)] = data;
-        }
+    else if (address < 0x3F00) {
+        nametablePages[(address >> 10) & 0x03][address & 0x03FF] = data;
     }
     // 3. Palette
-    else if (address >= 0x3F00) {
+    else {
         address &= 0x001F;
         if ((address & 0x03) == 0) address &= 0x0F;
         tblPalette[address] = data;
+        resolvePalette();
+    }
+}
+
+// Points the four nametables at cartridge VRAM or at the console's two
+// 1KB pages as the mirroring mode arranges them. Called by the bus
+// whenever the cartridge's mirror version changes.
+void PPU::mapNametables() {
+    MirrorMode mode = cart->getMirroring();
+    for (int table = 0; table < 4; ++table) {
+        if (uint8_t* page = cart->ppuNametablePage(table)) {
+            nametablePages[table] = page;
+            continue;
+        }
+        int page_index = 0;
+        if (mode == MirrorMode::VERTICAL) page_index = table & 0x01;
+        else if (mode == MirrorMode::HORIZONTAL) page_index = table >> 1;
+        else if (mode == MirrorMode::ONESCREEN_HI) page_index = 1;
+        nametablePages[table] = &tblName[page_index * 0x0400];
     }
+    if (deferred) deferred->logNametables(dot_clock, nametablePages);
+}
+
+void PPU::chrBanksSwitched() {
+    if (deferred) deferred->logPatternBanks(dot_clock, patterns->bankOffset);
 }
 
 // =============================================================
@@ -133,6 +125,7 @@ uint8_t PPU::cpuRead(uint16_t address) {
     uint8_t data = 0x00;
     switch (address & 0x0007) {
         case 0x0002: // STATUS
+            if (deferred && address_latch) deferred->logRegisterRead(dot_clock, 0x0002);
             data = (ppustatus & 0xE0) | (ppu_data_buffer & 0x1F);
             ppustatus &= ~0x80; // Clear VBlank
             address_latch = false;
@@ -141,6 +134,7 @@ uint8_t PPU::cpuRead(uint16_t address) {
             data = oamData[oamaddr];
             break;
         case 0x0007: // DATA
+            if (deferred) deferred->logRegisterRead(dot_clock, 0x0007);
             data = ppu_data_buffer;
             ppu_data_buffer = ppuRead(v_ram_addr);
             if (v_ram_addr >= 0x3F00) data = ppu_data_buffer;
@@ -151,19 +145,23 @@ uint8_t PPU::cpuRead(uint16_t address) {
 }
 
 void PPU::cpuWrite(uint16_t address, uint8_t data) {
+    if (deferred) deferred->logRegisterWrite(dot_clock, address & 0x0007, data);
+    line_dirty = true;
     switch (address & 0x0007) {
         case 0x0000: // CTRL
             ppuctrl = data;
+            sprite_line_stale = true; // Sprite size and pattern table
             t_ram_addr = (t_ram_addr & 0xF3FF) | ((static_cast<uint16_t>(data) & 0x03) << 10);
             break;
         case 0x0001: // MASK
             ppumask = data;
+            resolvePalette();
             break;
         case 0x0003: // OAMADDR
             oamaddr = data; 
             break;
         case 0x0004: // OAMDATA
-            oamData[oamaddr++] = data; 
+            writeOAM(oamaddr++, data);
             break;
         case 0x0005: // SCROLL
             if (!address_latch) {
@@ -188,14 +186,84 @@ void PPU::cpuWrite(uint16_t address, uint8_t data) {
             break;
         case 0x0007: // DATA
             ppuWrite(v_ram_addr, data);
+            sprite_line_stale = true; // May be CHR-RAM
             v_ram_addr += (ppuctrl & 0x04) ? 32 : 1;
             break;
     }
 }
 
 void PPU::startOAMDMA(const std::array<uint8_t, 256>& data) {
+    if (deferred) deferred->logOAMDMA(dot_clock, data);
+    line_dirty = true;
     for (int i = 0; i < 256; ++i) {
-        oamData[(oamaddr + i) & 0xFF] = data[i];
+        writeOAM(static_cast<uint8_t>(oamaddr + i), data[i]);
+    }
+}
+
+// =============================================================
+// DEFERRED RENDERING
+// =============================================================
+
+void PPU::setDeferredRenderer(DeferredRenderer* renderer) {
+    deferred = renderer;
+    skip_pixels = skip_frame || deferred;
+    sprite_line_stale = true;
+    if (deferred && scanline == 0 && cycle == 0) deferred->lineStart(*this, dot_clock); // Just reset
+}
+
+// The state a replay copy starts a band from
+void PPU::copyState(const PPU& other) {
+    tblName = other.tblName;
+    setNametablePages(other.nametablePages, other.tblName.data());
+    tblPalette = other.tblPalette;
+    oamData = other.oamData;
+    oamFields = other.oamFields;
+
+    output = other.output;
+    resolvedPalette = other.resolvedPalette;
+    resolvedEntry = other.resolvedEntry;
+
+    ppuctrl = other.ppuctrl;
+    ppumask = other.ppumask;
+    ppustatus = other.ppustatus;
+    oamaddr = other.oamaddr;
+    v_ram_addr = other.v_ram_addr;
+    t_ram_addr = other.t_ram_addr;
+    fine_x = other.fine_x;
+    address_latch = other.address_latch;
+    ppu_data_buffer = other.ppu_data_buffer;
+
+    bg_shifter_pattern_lo = other.bg_shifter_pattern_lo;
+    bg_shifter_pattern_hi = other.bg_shifter_pattern_hi;
+    bg_shifter_attrib_lo = other.bg_shifter_attrib_lo;
+    bg_shifter_attrib_hi = other.bg_shifter_attrib_hi;
+    bg_next_tile_id = other.bg_next_tile_id;
+    bg_next_tile_attrib = other.bg_next_tile_attrib;
+    bg_next_tile_lsb = other.bg_next_tile_lsb;
+    bg_next_tile_msb = other.bg_next_tile_msb;
+
+    spriteScanline = other.spriteScanline;
+    sprite_line_stale = true; // other may have drawn sprite 0 only
+    sprite_count = other.sprite_count;
+    bSpriteZeroHitPossible = other.bSpriteZeroHitPossible;
+    bSpriteZeroBeingRendered = other.bSpriteZeroBeingRendered;
+
+    suppress_vbl = other.suppress_vbl;
+    nmiOccurred = other.nmiOccurred;
+    cycle = other.cycle;
+    scanline = other.scanline;
+    frame_count = other.frame_count;
+    dot_clock = other.dot_clock;
+    frame_complete = other.frame_complete;
+    line_dirty = other.line_dirty;
+}
+
+// Another PPU's nametable arrangement: pages inside its tblName (at
+// source) move to the same place in this one's, cartridge VRAM is shared
+void PPU::setNametablePages(const std::array<uint8_t*, 4>& pages, const uint8_t* source) {
+    for (int table = 0; table < 4; ++table) {
+        auto offset = reinterpret_cast<std::uintptr_t>(pages[table]) - reinterpret_cast<std::uintptr_t>(source);
+        nametablePages[table] = offset < tblName.size() ? &tblName[offset] : pages[table];
     }
 }
 
@@ -245,169 +313,582 @@ void PPU::loadBackgroundShifters() {
     bg_shifter_attrib_hi  = (bg_shifter_attrib_hi & 0xFF00) | ((bg_next_tile_attrib & 0b10) ? 0xFF : 0x00);
 }
 
-void PPU::updateShifters() {
+void PPU::updateShifters(int dots) {
     if (ppumask & 0x18) { 
-        bg_shifter_pattern_lo <<= 1;
-        bg_shifter_pattern_hi <<= 1;
-        bg_shifter_attrib_lo <<= 1;
-        bg_shifter_attrib_hi <<= 1;
+        bg_shifter_pattern_lo <<= dots;
+        bg_shifter_pattern_hi <<= dots;
+        bg_shifter_attrib_lo <<= dots;
+        bg_shifter_attrib_hi <<= dots;
     }
 }
 
+// The four fetches of one 8-dot group (nametable, attribute, pattern low
+// and high), all made from the same v
+void PPU::fetchBackgroundTile() {
+    bg_next_tile_id = ppuRead(0x2000 | (v_ram_addr & 0x0FFF));
+
+    uint16_t tile_x = v_ram_addr & 0x001F;
+    uint16_t tile_y = (v_ram_addr & 0x03E0) >> 5;
+    uint16_t nt_idx = (v_ram_addr & 0x0C00) >> 10;
+    uint16_t attr_addr = 0x23C0 | (nt_idx << 10) | ((tile_y / 4) << 3) | (tile_x / 4);
+    uint8_t shift = ((tile_y & 2) << 1) | (tile_x & 2);
+    bg_next_tile_attrib = (ppuRead(attr_addr) >> shift) & 0x03;
+
+    uint16_t pattern_base = (ppuctrl & 0x10) ? 0x1000 : 0x0000;
+    uint16_t row_addr = pattern_base + (static_cast<uint16_t>(bg_next_tile_id) * 16) + ((v_ram_addr >> 12) & 0x07);
+    bg_next_tile_lsb = ppuRead(row_addr);
+    bg_next_tile_msb = ppuRead(row_addr + 8);
+}
+
+// =============================================================
+// DOT ACTIONS
+// -----------------
+// What the dot path does on each dot, as flags, built at compile time.
+// Lines that behave alike share a row (pre-render, first visible, other
+// visible, last visible, post-render, VBlank start, rest of VBlank), so
+// lineClass maps all 262 lines onto 7 x 341 entries. Flags run in the
+// order step() applies them.
+// =============================================================
+
+namespace {
+
+enum DotAction : uint16_t {
+    CLEAR_FLAGS = 1 << 0,  // (-1,1): VBlank, sprite 0, overflow
+    ODD_SKIP    = 1 << 1,  // (0,0): skipped on odd frames while rendering
+    RENDER      = 1 << 2,
+    SHIFT       = 1 << 3,
+    FETCH_NT    = 1 << 4,  // Also reloads the shifters
+    FETCH_AT    = 1 << 5,
+    FETCH_LO    = 1 << 6,
+    FETCH_HI    = 1 << 7,
+    INC_X       = 1 << 8,
+    DUMMY_NT    = 1 << 9,  // 337, 339
+    INC_Y       = 1 << 10, // 256
+    DOT_257     = 1 << 11, // Shifter reload, horizontal transfer
+    EVALUATE    = 1 << 12, // Sprite evaluation for the next line
+    TRANSFER_Y  = 1 << 13, // Pre-render 280-304
+    VBLANK      = 1 << 14, // (241,1)
+    TILE_GROUP  = 1 << 15  // First dot of an 8-dot fetch group
+};
+
+enum LineClass : uint8_t { PRE_RENDER, FIRST_VISIBLE, VISIBLE, LAST_VISIBLE, POST_RENDER, VBLANK_START, VBLANK_LINE };
+constexpr int LINE_CLASSES = 7;
+
+constexpr LineClass classOf(int scanline) {
+    if (scanline == -1) return PRE_RENDER;
+    if (scanline == 0) return FIRST_VISIBLE;
+    if (scanline < 239) return VISIBLE;
+    if (scanline == 239) return LAST_VISIBLE;
+    if (scanline == 240) return POST_RENDER;
+    if (scanline == 241) return VBLANK_START;
+    return VBLANK_LINE;
+}
+
+constexpr uint16_t actionsAt(LineClass line, int cycle) {
+    uint16_t action = 0;
+    const bool fetching = line <= LAST_VISIBLE;
+    const bool visible = line >= FIRST_VISIBLE && line <= LAST_VISIBLE;
+    if (line == PRE_RENDER && cycle == 1) action |= CLEAR_FLAGS;
+    if (line == FIRST_VISIBLE && cycle == 0) action |= ODD_SKIP;
+    if (visible && cycle >= 1 && cycle <= 256) action |= RENDER;
+    if (fetching && ((cycle >= 1 && cycle <= 256) || (cycle >= 321 && cycle <= 336))) {
+        action |= SHIFT;
+        constexpr uint16_t group[8] = {FETCH_NT | TILE_GROUP, 0, FETCH_AT, 0, FETCH_LO, 0, FETCH_HI, INC_X};
+        action |= group[(cycle - 1) % 8];
+    }
+    if (fetching && (cycle == 337 || cycle == 339)) action |= DUMMY_NT;
+    if (fetching && cycle == 256) action |= INC_Y;
+    if (fetching && cycle == 257) action |= DOT_257 | (line != LAST_VISIBLE ? EVALUATE : 0);
+    if (line == PRE_RENDER && cycle >= 280 && cycle <= 304) action |= TRANSFER_Y;
+    if (line == VBLANK_START && cycle == 1) action |= VBLANK;
+    return action;
+}
+
+constexpr auto lineClass = [] {
+    std::array<uint8_t, 262> classes{};
+    for (int scanline = -1; scanline <= 260; ++scanline) classes[scanline + 1] = classOf(scanline);
+    return classes;
+}();
+
+constexpr auto dotActions = [] {
+    std::array<std::array<uint16_t, 341>, LINE_CLASSES> table{};
+    for (int line = 0; line < LINE_CLASSES; ++line) {
+        for (int cycle = 0; cycle < 341; ++cycle) table[line][cycle] = actionsAt(static_cast<LineClass>(line), cycle);
+    }
+    return table;
+}();
+
+static_assert(dotActions[VISIBLE][1] == (RENDER | SHIFT | FETCH_NT | TILE_GROUP), "tile group start");
+static_assert(dotActions[LAST_VISIBLE][257] == DOT_257, "no evaluation after line 239");
+static_assert(dotActions[POST_RENDER][1] == 0, "post-render line is idle");
+
+} // namespace
+
 // =============================================================
 // MAIN CYCLE LOOP
 // =============================================================
 
 bool PPU::step(int cycles) {
     bool frame_done = false;
+    const uint64_t first_dot = dot_clock;
+    dot_clock += cycles;
 
     for (int i = 0; i < cycles; ++i) {
-        
-        // --- VISIBLE FRAME ---
-        if (scanline >= -1 && scanline <= 239) {
-            
+#ifndef PPU_DOT_STEP
+        // --- WHOLE VISIBLE LINES ---
+        if (cycle == 0 && scanline >= 0 && scanline <= 239 && !line_dirty) {
+            const bool skip = scanline == 0 && (frame_count % 2) && (ppumask & 0x18);
+            const int line_dots = skip ? 340 : 341;
+            if (cycles - i >= line_dots) {
+                renderScanline();
+                scanline++;
+                i += line_dots - 1;
+                if (deferred) deferred->lineStart(*this, first_dot + i + 1);
+                continue;
+            }
+        }
+#endif
+
+        // --- POST-RENDER / VBLANK SPANS ---
+        if (int idle = std::min(idleDotsAhead(), cycles - i)) {
+            int dot = (scanline - 240) * 341 + cycle + idle;
+            scanline = static_cast<int16_t>(240 + dot / 341);
+            cycle = static_cast<int16_t>(dot % 341);
+            if (scanline >= 261) scanline = -1;
+            i += idle - 1;
+            continue;
+        }
+
+        const auto& actions = dotActions[lineClass[scanline + 1]];
+        uint16_t action = actions[cycle];
+
+        // Odd Frame Skip: dot (0,0) does the work of (0,1)
+        if ((action & ODD_SKIP) && (frame_count % 2) && (ppumask & 0x18)) {
+            cycle = 1;
+            action = actions[cycle];
+        }
+
+        // --- TILE GROUPS ---
+        // No write lands inside a span, so all four fetches of a group
+        // read the same v and memory whichever of its dots they run on.
+        // (-1,1) also clears the flags and takes the path below.
+        if ((action & (TILE_GROUP | CLEAR_FLAGS)) == TILE_GROUP && cycles - i >= 8) {
+            runTileGroup(action & RENDER);
+            i += 7;
+            action = actions[cycle] & INC_Y;
+        }
+
+        if (action) {
             // Clean Status on Pre-render
-            if (scanline == -1 && cycle == 1) {
+            if (action & CLEAR_FLAGS) {
                 ppustatus &= ~(0xE0); // Clear VBlank, Sprite0, Overflow
                 nmiOccurred = false; 
                 bSpriteZeroHitPossible = false;
                 suppress_vbl = false;
             }
 
-            // Odd Frame Skip
-            if (scanline == 0 && cycle == 0 && (frame_count % 2) && (ppumask & 0x18)) {
-                 cycle = 1; 
-            }
-
             // --- RENDER PIXEL ---
-            if (scanline >= 0 && scanline <= 239 && cycle >= 1 && cycle <= 256) {
-                renderPixel();
-            }
+            if (action & RENDER) renderPixel();
 
             // --- PIPELINE (Shift Registers & Fetches) ---
-            if ((cycle >= 1 && cycle <= 256) || (cycle >= 321 && cycle <= 336)) {
-                updateShifters();
+            if (action & SHIFT) updateShifters();
+            if (action & FETCH_NT) {
+                loadBackgroundShifters();
+                bg_next_tile_id = ppuRead(0x2000 | (v_ram_addr & 0x0FFF));
+            }
+            if (action & FETCH_AT) {
+                uint16_t tile_x = v_ram_addr & 0x001F;
+                uint16_t tile_y = (v_ram_addr & 0x03E0) >> 5;
+                uint16_t nt_idx = (v_ram_addr & 0x0C00) >> 10;
+                uint16_t attr_addr = 0x23C0 | (nt_idx << 10) | ((tile_y / 4) << 3) | (tile_x / 4);
                 
-                switch ((cycle - 1) % 8) {
-                    case 0:
-                        loadBackgroundShifters();
-                        bg_next_tile_id = ppuRead(0x2000 | (v_ram_addr & 0x0FFF));
-                        break;
-                    case 2:
-                        {
-                            uint16_t tile_x = v_ram_addr & 0x001F;
-                            uint16_t tile_y = (v_ram_addr & 0x03E0) >> 5;
-                            uint16_t nt_idx = (v_ram_addr & 0x0C00) >> 10;
-                            uint16_t attr_addr = 0x23C0 | (nt_idx << 10) | ((tile_y / 4) << 3) | (tile_x / 4);
-                            
-                            uint8_t shift = ((tile_y & 2) << 1) | (tile_x & 2);
-                            bg_next_tile_attrib = (ppuRead(attr_addr) >> shift) & 0x03;
-                        }
-                        break;
-                    case 4:
-                        {
-                            uint16_t pattern_base = (ppuctrl & 0x10) ? 0x1000 : 0x0000;
-                            bg_next_tile_lsb = ppuRead(pattern_base + (static_cast<uint16_t>(bg_next_tile_id) * 16) + ((v_ram_addr >> 12) & 0x07));
-                        }
-                        break;
-                    case 6:
-                        {
-                            uint16_t pattern_base = (ppuctrl & 0x10) ? 0x1000 : 0x0000;
-                            bg_next_tile_msb = ppuRead(pattern_base + (static_cast<uint16_t>(bg_next_tile_id) * 16) + ((v_ram_addr >> 12) & 0x07) + 8);
-                        }
-                        break;
-                    case 7:
-                        if (ppumask & 0x18) incrementScrollX();
-                        break;
-                }
+                uint8_t shift = ((tile_y & 2) << 1) | (tile_x & 2);
+                bg_next_tile_attrib = (ppuRead(attr_addr) >> shift) & 0x03;
+            }
+            if (action & (FETCH_LO | FETCH_HI)) {
+                uint16_t pattern_base = (ppuctrl & 0x10) ? 0x1000 : 0x0000;
+                uint16_t row_addr = pattern_base + (static_cast<uint16_t>(bg_next_tile_id) * 16) + ((v_ram_addr >> 12) & 0x07);
+                if (action & FETCH_LO) bg_next_tile_lsb = ppuRead(row_addr);
+                else bg_next_tile_msb = ppuRead(row_addr + 8);
             }
+            if ((action & INC_X) && (ppumask & 0x18)) incrementScrollX();
 
-            if (cycle == 337 || cycle == 339) {
+            if (action & DUMMY_NT) {
                 bg_next_tile_id = ppuRead(0x2000 | (v_ram_addr & 0x0FFF));
             }
 
-            if (cycle == 256) {
-                if (ppumask & 0x18) incrementScrollY();
-            }
+            if ((action & INC_Y) && (ppumask & 0x18)) incrementScrollY();
 
-            if (cycle == 257) {
+            if (action & DOT_257) {
                 loadBackgroundShifters();
                 if (ppumask & 0x18) transferAddressX();
-                if (scanline >= -1 && scanline < 239) evaluateSprites();
+                if (action & EVALUATE) evaluateSprites();
             }
 
-            if (scanline == -1 && cycle >= 280 && cycle <= 304) {
-                if (ppumask & 0x18) transferAddressY();
-            }
-        }
+            if ((action & TRANSFER_Y) && (ppumask & 0x18)) transferAddressY();
 
-        // --- VBLANK START ---
-        if (scanline == 241 && cycle == 1) {
-            if (!suppress_vbl) {
-                ppustatus |= 0x80;
-                if (ppuctrl & 0x80) nmiOccurred = true;
+            // --- VBLANK START ---
+            if (action & VBLANK) {
+                if (!suppress_vbl) {
+                    ppustatus |= 0x80;
+                    if (ppuctrl & 0x80) nmiOccurred = true;
+                }
+                frame_done = true;
+                frame_count++;
             }
-            frame_done = true;
-            frame_count++;
         }
 
         cycle++;
         if (cycle >= 341) {
             cycle = 0;
             scanline++;
+            line_dirty = false;
             if (scanline >= 261) {
                 scanline = -1;
             }
+            if (deferred && scanline <= 240) deferred->lineStart(*this, first_dot + i + 1);
         }
     }
     return frame_done;
 }
 
+// Dots c to c + 7 of a fetch group (c - 1 a multiple of 8) in one go,
+// leaving cycle on the last of them: the pixels, the shifts, the four
+// fetches and the horizontal increment
+void PPU::runTileGroup(bool render) {
+    if (render) renderPixel();
+    updateShifters();
+    loadBackgroundShifters();
+    fetchBackgroundTile();
+    for (int dot = 1; dot < 8; ++dot) {
+        cycle++;
+        if (render) renderPixel();
+        updateShifters();
+    }
+    if (ppumask & 0x18) incrementScrollX();
+}
+
+// Lines 240-260 do nothing per dot except set VBlank at (241,1), so a
+// caught-up PPU can jump over them. Returns the dots that can be skipped
+// from the current position without reaching that dot or line -1.
+int PPU::idleDotsAhead() const {
+    if (scanline < 240) return 0;
+    constexpr int vblank_dot = 341 + 1;  // (241,1) relative to (240,0)
+    constexpr int end_dot = 21 * 341;    // (-1,0)
+    int dot = (scanline - 240) * 341 + cycle;
+    if (dot < vblank_dot) return vblank_dot - dot;
+    if (dot == vblank_dot) return 0;
+    return end_dot - dot;
+}
+
+int PPU::dotsUntilVBlank() const {
+    constexpr int frame_dots = 262 * 341;
+    constexpr int vblank_dot = (241 + 1) * 341 + 1; // Scanline 241, cycle 1
+    int dot = (scanline + 1) * 341 + cycle;
+    int dots = (vblank_dot - dot + frame_dots) % frame_dots;
+
+    // The odd-frame skip at (0,0) lies ahead unless VBlank comes first
+    bool before_skip = scanline == -1 || scanline > 241 || (scanline == 241 && cycle > 1) ||
+                       (scanline == 0 && cycle == 0);
+    if (before_skip && (frame_count % 2) && (ppumask & 0x18)) dots--;
+    return dots;
+}
+
+// Conservative bound for $2002 polling loops, assuming no register or OAM
+// writes in between: VBlank set/clear, plus sprite-0 hit and overflow on
+// the lines where OAM could still produce them this frame.
+int PPU::dotsUntilStatusChange() const {
+    constexpr int frame_dots = 262 * 341;
+    const int dot = (scanline + 1) * 341 + cycle;
+    auto until = [&](int line, int line_cycle) {
+        return ((line + 1) * 341 + line_cycle - dot + frame_dots) % frame_dots;
+    };
+
+    int dots = std::min(until(241, 1), until(-1, 1));
+    const int height = (ppuctrl & 0x20) ? 16 : 8;
+
+    if (!(ppustatus & 0x40) && (ppumask & 0x18) == 0x18) {
+        const int y = oamData[0];
+        for (int line = y; line < y + height && line <= 239; ++line) {
+            if (line == scanline && cycle <= 256) return 0;
+            dots = std::min(dots, until(line, 1));
+        }
+    }
+
+    if (!(ppustatus & 0x20)) {
+        std::array<std::uint8_t, 240> count{};
+        for (int i = 0; i < 64; ++i) {
+            const int y = oamData[i * 4];
+            for (int line = y; line < y + height && line <= 239; ++line) count[line]++;
+        }
+        for (int line = 0; line <= 239; ++line) {
+            if (count[line] > 8) dots = std::min(dots, until(line - 1, 257));
+        }
+    }
+
+    return dots;
+}
+
+// =============================================================
+// SPRITE EVALUATION
+// -----------------
+// Which of the 64 sprites cover a line, as a bitmask (bit i = sprite i),
+// from the Y row of oamFields: line - y must lie in [0, height). Unsigned
+// bytes throughout: y <= line as max(y, line) == line, and line - y <
+// height as min(line - y, height - 1) == line - y.
+// =============================================================
+
+using RangeKernel = uint64_t (*)(const uint8_t* y, int line, int height);
+
+static uint64_t spritesInRangeScalar(const uint8_t* y, int line, int height) {
+    uint64_t mask = 0;
+    for (int i = 0; i < 64; ++i) {
+        int diff = line - y[i];
+        if (diff >= 0 && diff < height) mask |= uint64_t{1} << i;
+    }
+    return mask;
+}
+
+#ifdef PPU_SIMD
+
+static uint64_t spritesInRangeSSE2(const uint8_t* y, int line, int height) {
+    const __m128i l = _mm_set1_epi8(static_cast<char>(line));
+    const __m128i h = _mm_set1_epi8(static_cast<char>(height - 1));
+    uint64_t mask = 0;
+    for (int i = 0; i < 64; i += 16) {
+        __m128i ys = _mm_load_si128(reinterpret_cast<const __m128i*>(y + i));
+        __m128i diff = _mm_sub_epi8(l, ys);
+        __m128i above = _mm_cmpeq_epi8(_mm_max_epu8(ys, l), l);
+        __m128i near = _mm_cmpeq_epi8(_mm_min_epu8(diff, h), diff);
+        mask |= static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(_mm_and_si128(above, near)))) << i;
+    }
+    return mask;
+}
+
+__attribute__((target("avx2")))
+static uint64_t spritesInRangeAVX2(const uint8_t* y, int line, int height) {
+    const __m256i l = _mm256_set1_epi8(static_cast<char>(line));
+    const __m256i h = _mm256_set1_epi8(static_cast<char>(height - 1));
+    uint64_t mask = 0;
+    for (int i = 0; i < 64; i += 32) {
+        __m256i ys = _mm256_load_si256(reinterpret_cast<const __m256i*>(y + i));
+        __m256i diff = _mm256_sub_epi8(l, ys);
+        __m256i above = _mm256_cmpeq_epi8(_mm256_max_epu8(ys, l), l);
+        __m256i near = _mm256_cmpeq_epi8(_mm256_min_epu8(diff, h), diff);
+        mask |= static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_and_si256(above, near)))) << i;
+    }
+    return mask;
+}
+
+#endif
+
+static RangeKernel selectRangeKernel() {
+#ifdef PPU_SIMD
+    if (__builtin_cpu_supports("avx2")) return spritesInRangeAVX2;
+    return spritesInRangeSSE2; // Part of x86-64
+#else
+    return spritesInRangeScalar;
+#endif
+}
+
+uint64_t spritesInRange(const uint8_t* y, int line, int height, SimdLevel level) {
+#ifdef PPU_SIMD
+    if (level == SimdLevel::AVX2) return spritesInRangeAVX2(y, line, height);
+    if (level == SimdLevel::SSE2) return spritesInRangeSSE2(y, line, height);
+#endif
+    (void)level;
+    return spritesInRangeScalar(y, line, height);
+}
+
+// The first 8 sprites in range go to spriteScanline; a 9th sets overflow
 void PPU::evaluateSprites() {
+    static const RangeKernel spritesInRange = selectRangeKernel();
+
     spriteScanline.clear();
     sprite_count = 0;
     
     int next_scanline = (scanline + 1);
     uint8_t sprite_height = (ppuctrl & 0x20) ? 16 : 8;
-    bool next_sprite_zero_hit = false;
-
-    for (int i = 0; i < 64; i++) {
-        int y = oamData[i * 4];
-        int diff = next_scanline - y;
-
-        if (diff >= 0 && diff < sprite_height) {
-            if (sprite_count < 8) {
-                ObjectAttrEntry entry;
-                entry.y = y;
-                entry.id = oamData[i * 4 + 1];
-                entry.attribute = oamData[i * 4 + 2];
-                entry.x = oamData[i * 4 + 3];
-                entry.isZero = (i == 0);
-                
-                if (i == 0) next_sprite_zero_hit = true;
-                
-                spriteScanline.push_back(entry);
-                sprite_count++;
-            } else {
-                ppustatus |= 0x20; 
-                break; 
+
+    uint64_t hits = spritesInRange(oamFields[0].data(), next_scanline, sprite_height);
+    bSpriteZeroBeingRendered = hits & 1;
+    for (; hits && sprite_count < 8; hits &= hits - 1) {
+        const int i = __builtin_ctzll(hits);
+        spriteScanline.push_back(ObjectAttrEntry{oamFields[0][i], oamFields[1][i], oamFields[2][i], oamFields[3][i], i == 0});
+        sprite_count++;
+    }
+    if (hits) ppustatus |= 0x20;
+
+    renderSpriteLine(next_scanline);
+}
+
+// Draws the sprites in spriteScanline for the given line into spriteLine,
+// earlier OAM entries winning where opaque pixels overlap (only sprite 0
+// on skipped frames). A $2000 or
+// $2007 write or a mapper write marks the buffer stale, and the next
+// lookup redraws it from the state at that point, as the per-pixel search
+// would have seen it. Enable and left-clip bits apply at lookup time.
+void PPU::renderSpriteLine(int line) {
+    spriteLine.fill(SpritePixel{});
+    sprite_line_stale = false;
+
+    const uint8_t height = (ppuctrl & 0x20) ? 16 : 8;
+    for (const auto& sprite : spriteScanline) {
+        if (skip_pixels && !sprite.isZero) break; // Sprite 0 is always first
+
+        bool flip_h = sprite.attribute & 0x40;
+        bool flip_v = sprite.attribute & 0x80;
+        int diff_y = line - sprite.y;
+
+        if (flip_v) diff_y = height - 1 - diff_y;
+
+        uint16_t ptrn_addr;
+        if (height == 8) {
+            ptrn_addr = ((ppuctrl & 0x08) ? 0x1000 : 0x0000) + (sprite.id * 16) + diff_y;
+        } else {
+            int row = diff_y % 8;
+            int tile_offset = (diff_y >= 8) ? 1 : 0;
+            int tile_num = (sprite.id & 0xFE) + tile_offset;
+            ptrn_addr = ((sprite.id & 1) ? 0x1000 : 0x0000) + (tile_num * 16) + row;
+        }
+
+        // 2-bit pixels in screen order, leftmost in bits 0-1
+        uint16_t pixels = 0;
+        if (!(ptrn_addr & 0x08) && ptrn_addr < 0x2000) {
+            const PatternRow& row = patterns->row(ptrn_addr);
+            pixels = flip_h ? row.flipped : row.normal;
+        } else {
+            // Row pushed off its tile by a mid-frame sprite size change
+            uint8_t p_lo = ppuRead(ptrn_addr);
+            uint8_t p_hi = ppuRead(ptrn_addr + 8);
+            for (int i = 0; i < 8; ++i) {
+                int bit = flip_h ? i : 7 - i;
+                pixels |= ((((p_hi >> bit) & 1) << 1) | ((p_lo >> bit) & 1)) << (2 * i);
+            }
+        }
+
+        for (int i = 0; i < 8 && sprite.x + i < 256; ++i) {
+            uint8_t pix = (pixels >> (2 * i)) & 0x03;
+            SpritePixel& out = spriteLine[sprite.x + i];
+            if (pix != 0 && out.pixel == 0) {
+                out.pixel = pix;
+                out.palette = (sprite.attribute & 0x03) + 4;
+                out.priority = (sprite.attribute & 0x20) == 0;
+                out.isZero = sprite.isZero;
             }
         }
     }
-    bSpriteZeroBeingRendered = next_sprite_zero_hit;
 }
 
-void PPU::renderPixel() {
+// =============================================================
+// SCANLINE RENDERER
+// -----------------
+// Runs dots 0-340 of a visible line in one call, for lines that no
+// register write, OAM DMA or mapper write can reach: step() only takes
+// this path when the whole line lies inside the span it was asked to run
+// (with the scheduler, spans end at the next PPU or mapper access) and
+// the line is not marked dirty. The fetches, scroll increments, sprite
+// evaluation, status bits and shifter state match the dot path exactly;
+// the background is just produced a tile at a time.
+// =============================================================
+
+void PPU::renderScanline() {
+    const bool rendering = ppumask & 0x18;
+
+    // A skipped frame only needs the background under sprite 0, and only
+    // while a hit is still possible
+    const bool hit_test = skip_pixels && bSpriteZeroBeingRendered && !(ppustatus & 0x40) && (ppumask & 0x18) == 0x18;
+    const bool show_bg = (ppumask & 0x08) && (!skip_pixels || hit_test);
+
+    // Background pixels in the order the shifters deliver them, as
+    // pixel | palette << 2: bit 0 of the tile fetched at the end of the
+    // previous line, the two prefetched tiles, then this line's tiles.
+    // Pixel x is entry x + fine_x, so the 32nd tile never shows.
+    std::array<uint8_t, 1 + 8 * 33> line{};
+    if (show_bg) {
+        for (int i = 0; i < 9; ++i) {
+            uint16_t bit_mux = 0x8000 >> i;
+            line[i] = ((bg_shifter_pattern_lo & bit_mux) ? 0x01 : 0) | ((bg_shifter_pattern_hi & bit_mux) ? 0x02 : 0) |
+                      ((bg_shifter_attrib_lo & bit_mux) ? 0x04 : 0) | ((bg_shifter_attrib_hi & bit_mux) ? 0x08 : 0);
+        }
+        for (int i = 0; i < 8; ++i) {
+            line[9 + i] = ((bg_next_tile_lsb >> (7 - i)) & 0x01) | (((bg_next_tile_msb >> (7 - i)) & 0x01) << 1) |
+                          (bg_next_tile_attrib << 2);
+        }
+    }
+
+    // Dots 1-256. The shifters need no upkeep here: once rendering, the
+    // 16 shifts at dots 321-336 push out everything older than the last
+    // fetch, and without rendering they only ever take new low bytes.
+    const uint16_t pattern_base = (ppuctrl & 0x10) ? 0x1000 : 0x0000;
+    for (int tile = 0; tile < 31; ++tile) {
+        if (show_bg) {
+            uint8_t id = ppuRead(0x2000 | (v_ram_addr & 0x0FFF));
+
+            uint16_t tile_x = v_ram_addr & 0x001F;
+            uint16_t tile_y = (v_ram_addr & 0x03E0) >> 5;
+            uint16_t nt_idx = (v_ram_addr & 0x0C00) >> 10;
+            uint16_t attr_addr = 0x23C0 | (nt_idx << 10) | ((tile_y / 4) << 3) | (tile_x / 4);
+            uint8_t shift = ((tile_y & 2) << 1) | (tile_x & 2);
+            uint8_t palette = ((ppuRead(attr_addr) >> shift) & 0x03) << 2;
+
+            uint16_t row = patterns->row(pattern_base + id * 16 + ((v_ram_addr >> 12) & 0x07)).normal;
+            for (int i = 0; i < 8; ++i) line[17 + tile * 8 + i] = ((row >> (2 * i)) & 0x03) | palette;
+        }
+        if (rendering) incrementScrollX();
+    }
+    fetchBackgroundTile(); // Latched into the shifters at dot 257
+    if (rendering) incrementScrollX();
+
+    auto backgroundAt = [&](int x) {
+        bg_pixel = 0x00;
+        bg_palette = 0x00;
+        if ((ppumask & 0x08) && ((ppumask & 0x02) || x >= 8)) {
+            bg_pixel = line[x + fine_x] & 0x03;
+            bg_palette = line[x + fine_x] >> 2;
+        }
+        bg_opaque = bg_pixel != 0;
+    };
+
+    if (!skip_pixels) {
+        for (int x = 0; x < 256; ++x) {
+            backgroundAt(x);
+            composePixel(x);
+        }
+    } else if (hit_test) {
+        const int sprite_x = spriteScanline.front().x;
+        for (int x = sprite_x; x < sprite_x + 8 && x < 256; ++x) {
+            backgroundAt(x);
+            checkSpriteZeroHit(x);
+        }
+    }
+
+    // Dots 256-257
+    if (rendering) incrementScrollY();
+    loadBackgroundShifters();
+    if (rendering) transferAddressX();
+    if (scanline < 239) evaluateSprites();
+
+    // Dots 321-336: the first two tiles of the next line
+    for (int tile = 0; tile < 2; ++tile) {
+        updateShifters();
+        loadBackgroundShifters();
+        fetchBackgroundTile();
+        updateShifters(7);
+        if (rendering) incrementScrollX();
+    }
+
+    // Dots 337 and 339
+    bg_next_tile_id = ppuRead(0x2000 | (v_ram_addr & 0x0FFF));
+}
+
+void PPU::renderBackground(int x, uint16_t bit_mux) {
     bg_pixel = 0x00;
     bg_palette = 0x00;
     bg_opaque = false;
 
-    int x = cycle - 1;
-
-    // --- BACKGROUND ---
     if (ppumask & 0x08) {
         if ((ppumask & 0x02) || (x >= 8)) {
-            uint16_t bit_mux = 0x8000 >> fine_x;
             uint8_t p0 = (bg_shifter_pattern_lo & bit_mux) > 0;
             uint8_t p1 = (bg_shifter_pattern_hi & bit_mux) > 0;
             bg_pixel = (p1 << 1) | p0;
@@ -419,7 +900,30 @@ void PPU::renderPixel() {
             if (bg_pixel != 0) bg_opaque = true;
         }
     }
+}
+
+void PPU::renderPixel() {
+    int x = cycle - 1;
+    if (skip_pixels) {
+        if (!bSpriteZeroBeingRendered || (ppustatus & 0x40)) return;
+        renderBackground(x, 0x8000 >> fine_x);
+        checkSpriteZeroHit(x);
+        return;
+    }
+    renderBackground(x, 0x8000 >> fine_x);
+    composePixel(x);
+}
 
+// The sprite-0 hit test of composePixel() on its own, for skipped frames
+void PPU::checkSpriteZeroHit(int x) {
+    if ((ppumask & 0x18) != 0x18 || ((ppumask & 0x06) != 0x06 && x < 8) || x >= 255) return;
+    if (sprite_line_stale) renderSpriteLine(scanline);
+    if (bg_opaque && spriteLine[x].isZero) ppustatus |= 0x40;
+}
+
+// Sprites, sprite-0 hit and the final colour for pixel x of the current
+// line, on top of the background pixel in bg_pixel/bg_palette
+void PPU::composePixel(int x) {
     // --- SPRITES ---
     sp_pixel = 0x00;
     sp_palette = 0x00;
@@ -428,41 +932,12 @@ void PPU::renderPixel() {
 
     if (ppumask & 0x10) {
         if ((ppumask & 0x04) || (x >= 8)) {
-            for (const auto& sprite : spriteScanline) {
-                int diff_x = x - sprite.x;
-                
-                if (diff_x >= 0 && diff_x < 8) {
-                    uint8_t height = (ppuctrl & 0x20) ? 16 : 8;
-                    bool flip_h = sprite.attribute & 0x40;
-                    bool flip_v = sprite.attribute & 0x80;
-                    int diff_y = scanline - sprite.y;
-                    
-                    if (flip_v) diff_y = height - 1 - diff_y;
-                    if (flip_h) diff_x = 7 - diff_x;
-                    
-                    uint16_t ptrn_addr;
-                    if (height == 8) {
-                        ptrn_addr = ((ppuctrl & 0x08) ? 0x1000 : 0x0000) + (sprite.id * 16) + diff_y;
-                    } else {
-                        int row = diff_y % 8;
-                        int tile_offset = (diff_y >= 8) ? 1 : 0;
-                        int tile_num = (sprite.id & 0xFE) + tile_offset;
-                        ptrn_addr = ((sprite.id & 1) ? 0x1000 : 0x0000) + (tile_num * 16) + row;
-                    }
-
-                    uint8_t p_lo = ppuRead(ptrn_addr);
-                    uint8_t p_hi = ppuRead(ptrn_addr + 8);
-                    uint8_t pix = (((p_hi >> (7 - diff_x)) & 1) << 1) | ((p_lo >> (7 - diff_x)) & 1);
-                    
-                    if (pix != 0) {
-                        sp_pixel = pix;
-                        sp_palette = (sprite.attribute & 0x03) + 4;
-                        sp_priority = (sprite.attribute & 0x20) == 0;
-                        if (sprite.isZero) sp_0_rendered = true;
-                        break; 
-                    }
-                }
-            }
+            if (sprite_line_stale) renderSpriteLine(scanline);
+            const SpritePixel& sprite = spriteLine[x];
+            sp_pixel = sprite.pixel;
+            sp_palette = sprite.palette;
+            sp_priority = sprite.priority;
+            sp_0_rendered = sprite.isZero;
         }
     }
 
@@ -476,46 +951,33 @@ void PPU::renderPixel() {
     }
 
     // --- COMPOSITING ---
-    uint32_t final_color;
+    uint8_t index;
     if (bg_pixel == 0 && sp_pixel == 0) {
-        final_color = getColorFromPaletteRam(0, 0);
+        index = 0;
     } else if (bg_pixel == 0) {
-        final_color = getColorFromPaletteRam(sp_palette, sp_pixel);
+        index = sp_palette * 4 + sp_pixel;
     } else if (sp_pixel == 0) {
-        final_color = getColorFromPaletteRam(bg_palette, bg_pixel);
+        index = bg_palette * 4 + bg_pixel;
     } else {
-        final_color = sp_priority ? getColorFromPaletteRam(sp_palette, sp_pixel) 
-                                  : getColorFromPaletteRam(bg_palette, bg_pixel);
+        index = sp_priority ? sp_palette * 4 + sp_pixel 
+                            : bg_palette * 4 + bg_pixel;
     }
 
-    if (ppumask & 0x01) final_color = applyGrayscale(final_color);
-    final_color = applyEmphasis(final_color);
-    pixels[scanline * 256 + x] = final_color;
-}
-
-uint32_t PPU::getColorFromPaletteRam(uint8_t palette, uint8_t pixel) {
-    return systemPalette[ppuRead(0x3F00 + (palette * 4) + pixel) & 0x3F];
+    if (output == OutputMode::INDEXED) {
+        if (x == 0) indexed->modes[scanline] = colorMode(ppumask);
+        indexed->pixels[scanline * 256 + x] = resolvedEntry[index];
+    } else {
+        screen[scanline * 256 + x] = resolvedPalette[index];
+    }
 }
 
-uint32_t PPU::applyGrayscale(uint32_t color) {
-    uint8_t r = (color >> 16) & 0xFF;
-    uint8_t g = (color >> 8) & 0xFF;
-    uint8_t b = color & 0xFF;
-    uint8_t gray = static_cast<uint8_t>(0.299 * r + 0.587 * g + 0.114 * b);
-    return 0xFF000000 | (gray << 16) | (gray << 8) | gray;
+// Refreshes the final colour of all 32 palette RAM indices. Called on
+// palette RAM and PPUMASK writes, the only inputs to those colours.
+void PPU::resolvePalette() {
+    const auto& colors = colorTable[colorMode(ppumask)];
+    for (int i = 0; i < 32; ++i) {
+        int address = ((i & 0x03) == 0) ? (i & 0x0F) : i; // Mirror bg colors
+        resolvedEntry[i] = tblPalette[address] & 0x3F;
+        resolvedPalette[i] = colors[resolvedEntry[i]];
+    }
 }
-
-uint32_t PPU::applyEmphasis(uint32_t color) {
-    uint8_t emphasis = (ppumask >> 5) & 0x07;
-    if (emphasis == 0) return color;
-    
-    uint8_t r = (color >> 16) & 0xFF;
-    uint8_t g = (color >> 8) & 0xFF;
-    uint8_t b = color & 0xFF;
-    
-    if (!(emphasis & 0x01)) r = r * 3 / 4;
-    if (!(emphasis & 0x02)) g = g * 3 / 4;
-    if (!(emphasis & 0x04)) b = b * 3 / 4;
-    
-    return 0xFF000000 | (r << 16) | (g << 8) | b;
-}
\ No newline at end of file
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstdint>
+#include <array>
+
+class Core;
+class Bus;
+
+// =============================================================
+// SCHEDULER
+// -----------------
+// Master timeline in PPU dots (3 per CPU cycle). The CPU runs ahead one
+// instruction at a time and only bumps the clock; the PPU and APU are
+// brought up to date when the clock passes the earliest pending deadline,
+// or when the CPU accesses them, which syncs that device to the start of
+// the instruction: the PPU on $2000-$3FFF, OAM DMA and mapper writes (CHR
+// banks, mirroring), the APU on its registers. This is the same order of
+// effects as stepping every device after every instruction, so timing and
+// output are unchanged, while the PPU runs long spans per call.
+//
+// Deadlines are the events the CPU can observe without an I/O access:
+// VBlank (NMI edge and end of frame) and the APU frame IRQ. Sprite-0 hit,
+// overflow and DMA are only visible through register accesses, and no
+// mapper in this tree raises an IRQ, so none of them need an entry.
+// =============================================================
+
+class Scheduler {
+    public:
+        Scheduler(Core& core, Bus& bus);
+        ~Scheduler();
+
+        Scheduler(const Scheduler&) = delete;
+        Scheduler& operator=(const Scheduler&) = delete;
+
+        void runFrame(); // Runs until the PPU enters VBlank
+        void sync();     // Catches the PPU and APU up to the current instruction
+
+        // Catch one device up ahead of a register access. The access may
+        // move its deadline, so deadlines are re-evaluated once the
+        // instruction has finished.
+        void syncPPU();
+        void syncAPU();
+
+        // Dots the PPU (or APU, in dots) still has to run to reach now
+        std::uint64_t ppuLag() const;
+        std::uint64_t apuLag() const { return now - apu_time; }
+
+        std::uint64_t getClock() const { return now; }
+
+    private:
+        enum Deadline { VBLANK, FRAME_IRQ, DEADLINE_COUNT };
+
+        void reschedule();
+
+        Core& core;
+        Bus& bus;
+
+        std::uint64_t now = 0;      // Start of the next CPU instruction
+        std::uint64_t apu_time = 0; // Dots the APU has run (always a multiple of 3)
+
+        std::array<std::uint64_t, DEADLINE_COUNT> deadlines{};
+        std::uint64_t next_deadline = 0;
+        bool frame_done = false;
+};
@@ -0,0 +1,66 @@
+#include "scheduler.hpp"
+
+#include <algorithm>
+#include <limits>
+
+#include "bus.hpp"
+#include "core.hpp"
+
+Scheduler::Scheduler(Core& core_ref, Bus& bus_ref) : core(core_ref), bus(bus_ref) {
+    now = apu_time = bus.ppu.getDotClock();
+    bus.attachScheduler(this);
+    reschedule();
+}
+
+Scheduler::~Scheduler() {
+    bus.attachScheduler(nullptr);
+}
+
+void Scheduler::runFrame() {
+    frame_done = false;
+    while (!frame_done) {
+        core.step();
+
+        now += 3 * static_cast<std::uint64_t>(core.last_cycles + bus.dma_cycles);
+        bus.dma_cycles = 0; // consumed
+
+        if (now >= next_deadline) sync();
+    }
+}
+
+void Scheduler::sync() {
+    syncPPU();
+    syncAPU();
+    reschedule();
+}
+
+void Scheduler::syncPPU() {
+    if (bus.ppu.catchUp(now)) frame_done = true;
+    next_deadline = now;
+}
+
+void Scheduler::syncAPU() {
+    if (apu_time != now) {
+        bus.apu.step(static_cast<int>((now - apu_time) / 3));
+        apu_time = now;
+    }
+    next_deadline = now;
+}
+
+std::uint64_t Scheduler::ppuLag() const {
+    return now - bus.ppu.getDotClock();
+}
+
+// Deadlines are the first clock value at which the event has happened,
+// i.e. the instruction ending there must be followed by a sync. The VBlank
+// dot itself has to be run, the frame IRQ fires within the last APU cycle.
+void Scheduler::reschedule() {
+    deadlines[VBLANK] = bus.ppu.getDotClock() + bus.ppu.dotsUntilVBlank() + 1;
+
+    int irq_cycles = bus.apu.cyclesUntilFrameIRQ();
+    deadlines[FRAME_IRQ] = irq_cycles == std::numeric_limits<int>::max()
+        ? std::numeric_limits<std::uint64_t>::max()
+        : apu_time + 3 * static_cast<std::uint64_t>(irq_cycles);
+
+    next_deadline = *std::min_element(deadlines.begin(), deadlines.end());
+}
@@ -0,0 +1,169 @@
+// CPU opcode metadata tests.
+//
+// instr_length and instr_cycles (policies_map.hpp) are written by hand next
+// to the Instr<> bodies they describe, and the block cache, the idle-loop
+// fast-forward and the JIT all trust them. Here every opcode is executed
+// once from flat test RAM and what it actually did is compared with them.
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "bus.hpp"
+#include "core.hpp"
+#include "policies_map.hpp"
+
+static int failures = 0;
+
+static void check(bool cond, std::uint8_t opcode, const std::string& what) {
+    if (cond) return;
+    static const char hex[] = "0123456789ABCDEF";
+    std::cerr << "FAIL opcode $" << hex[opcode >> 4] << hex[opcode & 0x0F] << ": " << what << "\n";
+    failures++;
+}
+
+static bool isBranch(std::uint8_t opcode) { return (opcode & 0x1F) == 0x10; }
+static bool isJam(std::uint8_t opcode) {
+    return ((opcode & 0x0F) == 0x02 && opcode < 0x80) || opcode == 0x92 || opcode == 0xB2 || opcode == 0xD2 || opcode == 0xF2;
+}
+
+// Program and data every opcode runs against. Code at $0400, operands
+// $10 $02 (zero page $10, absolute $0210), the $10 pointer and the $0210
+// JMP vector both lead to $0500, the IRQ/BRK vector to $0600. X and Y
+// are 0 so no indexed access crosses a page.
+static constexpr std::uint16_t START = 0x0400;
+static constexpr std::uint8_t OPERAND_LO = 0x10;
+static constexpr std::uint8_t OPERAND_HI = 0x02;
+static constexpr std::uint8_t POISON = 0xA5; // Stands in for bytes beyond the instruction
+
+struct Result {
+    CpuRegisters regs;
+    int cycles;
+    std::vector<std::uint8_t> ram;
+};
+
+static void load(Bus& bus, Core& core, std::uint8_t opcode, std::uint8_t p, bool operands_in_memory) {
+    std::fill(bus.testRam.begin(), bus.testRam.end(), 0);
+    bus.write(0x0010, 0x00);
+    bus.write(0x0011, 0x05);
+    bus.write(0x0210, 0x00);
+    bus.write(0x0211, 0x05);
+    bus.write(0xFFFE, 0x00);
+    bus.write(0xFFFF, 0x06);
+    bus.write(0x01FD, 0xC3); // Stack: P, PCL, PCH for RTI; PCL, PCH for RTS
+    bus.write(0x01FE, 0x34);
+    bus.write(0x01FF, 0x12);
+
+    bus.write(START, opcode);
+    for (int i = 1; i < 4; ++i) bus.write(static_cast<std::uint16_t>(START + i), POISON);
+    if (operands_in_memory) {
+        bus.write(START + 1, OPERAND_LO);
+        bus.write(START + 2, OPERAND_HI);
+    }
+
+    core.regs = CpuRegisters{};
+    core.regs.pc = START;
+    core.regs.s = 0xFC;
+    core.regs.setP(p);
+}
+
+// Runs the opcode from the bus (step) or, like the block cache, from a
+// DecodedInstr holding instr_length[opcode] - 1 operand bytes. In the
+// decoded run memory past the opcode is poisoned, so an Instr<> that
+// fetches more bytes than the table says reads something else.
+static Result run(Bus& bus, Core& core, std::uint8_t opcode, std::uint8_t p, bool decoded) {
+    load(bus, core, opcode, p, !decoded);
+    if (decoded) {
+        DecodedInstr ins{};
+        ins.handler = instr_fns[opcode];
+        ins.pc = START;
+        ins.opcode = opcode;
+        ins.length = instr_length[opcode];
+        ins.operand[0] = OPERAND_LO;
+        ins.operand[1] = OPERAND_HI;
+        core.execDecoded(ins);
+    } else {
+        core.step();
+    }
+    return {core.regs, core.last_cycles, bus.testRam};
+}
+
+static void testOpcode(Bus& bus, Core& core, std::uint8_t opcode, std::uint8_t p) {
+    const int length = instr_length[opcode];
+    const Result r = run(bus, core, opcode, p, false);
+    const std::uint16_t next = static_cast<std::uint16_t>(START + length);
+    const std::uint16_t target = 0x0500;
+
+    // Bytes fetched, seen through where PC (or the pushed PC) ended up
+    switch (opcode) {
+        case 0x00: // BRK pushes the address after its padding byte
+            check(r.regs.pc == 0x0600 && r.ram[0x01FC] == (next >> 8) && r.ram[0x01FB] == (next & 0xFF), opcode, "BRK length");
+            break;
+        case 0x20: // JSR pushes the address of its last byte
+            check(r.regs.pc == 0x0210 && r.ram[0x01FC] == ((next - 1) >> 8) && r.ram[0x01FB] == ((next - 1) & 0xFF), opcode, "JSR length");
+            break;
+        case 0x40: check(r.regs.pc == 0x1234, opcode, "RTI target"); break;
+        case 0x60: check(r.regs.pc == 0x34C4, opcode, "RTS target"); break;
+        case 0x4C: check(r.regs.pc == 0x0210 && length == 3, opcode, "JMP abs length"); break;
+        case 0x6C: check(r.regs.pc == target && length == 3, opcode, "JMP ind length"); break;
+        default:
+            if (isJam(opcode)) {
+                check(r.regs.pc == START && length == 1, opcode, "JAM length");
+            } else if (isBranch(opcode)) {
+                check(length == 2 && (r.regs.pc == next || r.regs.pc == next + OPERAND_LO), opcode, "branch length");
+            } else {
+                check(r.regs.pc == next, opcode, "length " + std::to_string(length) + ", PC moved " + std::to_string(r.regs.pc - START));
+            }
+            break;
+    }
+
+    // Base cycles: branches add one when taken (never a page crossing here)
+    int expected = instr_cycles[opcode];
+    if (isBranch(opcode) && r.regs.pc != next) expected++;
+    check(r.cycles == expected, opcode, "cycles " + std::to_string(instr_cycles[opcode]) + ", charged " + std::to_string(r.cycles));
+
+    // The decoded path must see exactly the operand bytes the bus path read
+    const Result d = run(bus, core, opcode, p, true);
+    check(d.regs.sameState(r.regs) && d.cycles == r.cycles, opcode, "decoded run differs from bus run");
+    for (std::size_t addr = 0; addr < d.ram.size(); ++addr) {
+        if (addr >= START && addr < START + 4u) continue; // Operands vs poison
+        if (d.ram[addr] != r.ram[addr]) {
+            check(false, opcode, "decoded run wrote different memory");
+            break;
+        }
+    }
+}
+
+// instr_ends_block must cover every opcode that does not run on to the
+// next instruction
+static void testEndsBlock(Bus& bus, Core& core, std::uint8_t opcode) {
+    const std::uint16_t next = static_cast<std::uint16_t>(START + instr_length[opcode]);
+    for (std::uint8_t p : {std::uint8_t{0x24}, std::uint8_t{0xE7}}) {
+        const Result r = run(bus, core, opcode, p, false);
+        if (r.regs.pc != next) check(instr_ends_block(opcode), opcode, "transfers control but does not end a block");
+    }
+}
+
+int main() {
+    Bus bus;
+    bus.setTestMode(true);
+    Core core(&bus);
+    init_instr_table(core);
+
+    for (int op = 0; op < 256; ++op) {
+        const std::uint8_t opcode = static_cast<std::uint8_t>(op);
+        // I stays set so no IRQ is taken; the flags flip between runs so
+        // every branch is seen both taken and not taken
+        testOpcode(bus, core, opcode, 0x24);
+        testOpcode(bus, core, opcode, 0xE7);
+        testEndsBlock(bus, core, opcode);
+    }
+
+    if (failures) {
+        std::cerr << failures << " CPU test(s) failed\n";
+        return 1;
+    }
+    std::cout << "CPU opcode table tests passed\n";
+    return 0;
+}
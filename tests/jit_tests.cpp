@@ -0,0 +1,281 @@
+// JIT differential tests (build with `make test_jit`, Linux x86-64 only).
+//
+// The JIT re-implements the common opcodes in hand-encoded x86 and learns
+// how each opcode is put together from its own shape table. Here random
+// blocks are compiled from a synthetic NROM image and every native run is
+// replayed on the interpreter from the same starting state: registers
+// (CpuRegisters::sameState), internal RAM and the cycles charged must
+// agree. Every opcode that does not end a block leads one block; ADC and
+// SBC get extra trials for their flags, the branches get blocks that
+// cross a page, and random pointers and indices drive the I/O and
+// non-RAM side exits. Afterwards no mapping of the process may be
+// writable and executable at once.
+
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include "bus.hpp"
+#include "core.hpp"
+#include "jit.hpp"
+#include "block_cache.hpp"
+#include "cartridge.hpp"
+#include "policies_map.hpp"
+
+static int failures = 0;
+static std::mt19937 rng(0x6502);
+
+static std::uint8_t random8() { return static_cast<std::uint8_t>(rng()); }
+
+static std::string hex(unsigned value, int digits) {
+    static const char chars[] = "0123456789ABCDEF";
+    std::string s(digits, '0');
+    for (int i = digits - 1; i >= 0; --i, value >>= 4) s[i] = chars[value & 0x0F];
+    return s;
+}
+
+// Opcodes the JIT leaves to the interpreter mid-block (SHA, TAS, SHY, SHX):
+// they may appear in a block but never lead one
+static bool jitStops(std::uint8_t opcode) {
+    return opcode == 0x93 || opcode == 0x9B || opcode == 0x9C || opcode == 0x9E || opcode == 0x9F;
+}
+
+static bool isAdcSbc(std::uint8_t opcode) {
+    return (opcode & 0xE3) == 0x61 || (opcode & 0xE3) == 0xE1 || opcode == 0xEB;
+}
+
+// =============================================================
+// TEST CARTRIDGE
+// =============================================================
+
+struct Block {
+    std::uint16_t pc;
+    std::uint8_t lead;
+    int trials;
+};
+
+class Program {
+    public:
+        std::vector<std::uint8_t> prg = std::vector<std::uint8_t>(0x8000, 0xEA);
+        std::vector<Block> blocks;
+        std::uint16_t at = 0x8000;
+
+        void byte(std::uint8_t b) { prg[at++ - 0x8000] = b; }
+
+        // Operand bytes. Leading instructions stay on internal RAM so the
+        // block always compiles; the rest also reach I/O, PRG-RAM and ROM.
+        void operands(std::uint8_t opcode, bool lead) {
+            static const std::uint8_t pages[] = {0x00, 0x01, 0x03, 0x07, 0x1F, 0x20, 0x40, 0x60, 0x80, 0xC0};
+            if (instr_length[opcode] > 1) byte(random8());
+            if (instr_length[opcode] > 2) byte(lead ? random8() & 0x07 : pages[rng() % sizeof(pages)]);
+        }
+
+        void instr(std::uint8_t opcode, bool lead = false) {
+            byte(opcode);
+            operands(opcode, lead);
+        }
+
+        // A leading opcode, a few random straight-line ones and an exit:
+        // usually a branch, otherwise one of the jumps, calls and returns
+        void randomBlock(std::uint8_t lead, const std::vector<std::uint8_t>& pool, int trials) {
+            static const std::uint8_t exits[] = {0x4C, 0x6C, 0x20, 0x60, 0x40, 0x00};
+            blocks.push_back({at, lead, trials});
+            instr(lead, true);
+            for (int n = static_cast<int>(rng() % 4); n > 0; --n) instr(pool[rng() % pool.size()]);
+            if (rng() % 4) {
+                byte(static_cast<std::uint8_t>(0x10 | (rng() % 8) << 5));
+                byte(random8());
+            } else {
+                instr(exits[rng() % sizeof(exits)]);
+            }
+        }
+
+        // A flag-setting op and branch `offset` bytes away, placed so the
+        // branch sits at `branch_pc`
+        void branchBlock(std::uint8_t branch, std::uint16_t branch_pc, std::int8_t offset, int trials) {
+            at = static_cast<std::uint16_t>(branch_pc - 2);
+            blocks.push_back({at, 0x69, trials});
+            byte(0x69); // ADC #imm
+            byte(random8());
+            byte(branch);
+            byte(static_cast<std::uint8_t>(offset));
+        }
+
+        std::string writeImage() {
+            prg[0x7FFA] = prg[0x7FFC] = prg[0x7FFE] = 0x00; // Vectors to $8000
+            prg[0x7FFB] = prg[0x7FFD] = prg[0x7FFF] = 0x80;
+
+            char path[] = "/tmp/jit_tests_XXXXXX";
+            int fd = mkstemp(path);
+            if (fd < 0) return "";
+            close(fd);
+
+            const std::uint8_t header[16] = {'N', 'E', 'S', 0x1A, 2, 1};
+            std::ofstream out(path, std::ios::binary);
+            out.write(reinterpret_cast<const char*>(header), sizeof(header));
+            out.write(reinterpret_cast<const char*>(prg.data()), prg.size());
+            std::vector<char> chr(8192, 0);
+            out.write(chr.data(), chr.size());
+            return path;
+        }
+};
+
+// =============================================================
+// DIFFERENTIAL RUN
+// =============================================================
+
+struct State {
+    CpuRegisters regs;
+    std::array<std::uint8_t, 2048> ram;
+};
+
+static State capture(Core& core, Bus& bus) {
+    State s{core.regs, {}};
+    std::copy(bus.getRam(), bus.getRam() + 2048, s.ram.begin());
+    return s;
+}
+
+static void restore(Core& core, Bus& bus, const State& s) {
+    core.regs = s.regs;
+    std::copy(s.ram.begin(), s.ram.end(), bus.getRam());
+}
+
+// Half the RAM bytes are $00-$07, so pointers built from them land on
+// internal RAM as often as elsewhere
+static State randomState(std::uint16_t pc) {
+    State s{};
+    for (std::uint8_t& b : s.ram) {
+        const std::uint32_t r = rng();
+        b = static_cast<std::uint8_t>((r & 1) ? (r >> 8) & 0x07 : (r >> 8) & 0xFF);
+    }
+    s.regs.pc = pc;
+    s.regs.a = random8();
+    s.regs.x = random8();
+    s.regs.y = random8();
+    s.regs.s = random8();
+    s.regs.setP(random8());
+    return s;
+}
+
+// Interprets from the current state until `cycles` have been charged
+static int interpret(Core& core, int cycles) {
+    int total = 0;
+    while (total < cycles) {
+        std::uint8_t opcode = core.fetch();
+        instr_fns[opcode](core);
+        total += core.last_cycles;
+    }
+    return total;
+}
+
+static void fail(const Block& block, const State& start, const std::string& what) {
+    std::cerr << "FAIL block $" << hex(block.pc, 4) << " (lead $" << hex(block.lead, 2) << ", A=" << hex(start.regs.a, 2)
+              << " X=" << hex(start.regs.x, 2) << " Y=" << hex(start.regs.y, 2) << " P=" << hex(start.regs.getP(), 2)
+              << "): " << what << "\n";
+    failures++;
+}
+
+// Returns how many trials ran natively
+static int testBlock(Core& core, Bus& bus, Jit& jit, BlockCache& cache, const Block& block) {
+    // As in Core::step, the interpreter has looked the block up first
+    if (!cache.lookup(bus, block.pc)) return 0;
+
+    int native = 0;
+    for (int trial = 0; trial < block.trials + Jit::HOT_THRESHOLD; ++trial) {
+        const State start = randomState(block.pc);
+        restore(core, bus, start);
+
+        const int cycles = jit.run(core, bus, cache);
+        if (cycles == 0) {
+            if (!capture(core, bus).regs.sameState(start.regs)) fail(block, start, "declined block still changed state");
+            continue;
+        }
+        native++;
+        const State jitted = capture(core, bus);
+
+        restore(core, bus, start);
+        const int interpreted = interpret(core, cycles);
+        const State reference = capture(core, bus);
+
+        if (interpreted != cycles) {
+            fail(block, start, "JIT charged " + std::to_string(cycles) + " cycles, no instruction boundary there");
+        } else if (!jitted.regs.sameState(reference.regs)) {
+            fail(block, start, "registers: JIT PC=" + hex(jitted.regs.pc, 4) + " A=" + hex(jitted.regs.a, 2) +
+                 " P=" + hex(jitted.regs.getP(), 2) + ", interpreter PC=" + hex(reference.regs.pc, 4) +
+                 " A=" + hex(reference.regs.a, 2) + " P=" + hex(reference.regs.getP(), 2));
+        } else if (jitted.ram != reference.ram) {
+            fail(block, start, "RAM differs");
+        }
+    }
+    return native;
+}
+
+int main() {
+    std::vector<std::uint8_t> pool;
+    for (int op = 0; op < 256; ++op) {
+        if (!instr_ends_block(static_cast<std::uint8_t>(op))) pool.push_back(static_cast<std::uint8_t>(op));
+    }
+
+    Program program;
+    for (std::uint8_t lead : pool) {
+        if (jitStops(lead)) continue;
+        program.randomBlock(lead, pool, isAdcSbc(lead) ? 1024 : 64);
+    }
+    // Every branch across a page boundary, forwards and backwards
+    for (int cond = 0; cond < 8; ++cond) {
+        const std::uint8_t branch = static_cast<std::uint8_t>(0x10 | cond << 5);
+        const std::uint16_t page = static_cast<std::uint16_t>(0xC000 + cond * 0x0200);
+        program.branchBlock(branch, static_cast<std::uint16_t>(page + 0xFC), 0x20, 256);
+        program.branchBlock(branch, static_cast<std::uint16_t>(page + 0x0104), -0x10, 256);
+    }
+
+    const std::string image = program.writeImage();
+    auto cart = std::make_shared<Cartridge>(image);
+    std::remove(image.c_str());
+    if (!cart->ImageValid()) {
+        std::cerr << "Could not build the test cartridge\n";
+        return 1;
+    }
+
+    Bus bus;
+    bus.insertCartridge(cart);
+    Core core(&bus);
+    init_instr_table(core);
+    Jit jit;
+    BlockCache cache;
+
+    int blocks_run = 0;
+    for (const Block& block : program.blocks) {
+        if (testBlock(core, bus, jit, cache, block) > 0) {
+            blocks_run++;
+        } else {
+            std::cerr << "FAIL block $" << hex(block.pc, 4) << " (lead $" << hex(block.lead, 2) << ") never ran natively\n";
+            failures++;
+        }
+    }
+
+    // Permissions are the second field of /proc/self/maps ("rwxp")
+    std::ifstream maps("/proc/self/maps");
+    for (std::string line; std::getline(maps, line);) {
+        const std::size_t perms = line.find(' ') + 1;
+        if (line.compare(perms, 3, "rwx") == 0) {
+            std::cerr << "FAIL writable and executable mapping: " << line << "\n";
+            failures++;
+        }
+    }
+
+    if (failures) {
+        std::cerr << failures << " JIT test(s) failed\n";
+        return 1;
+    }
+    std::cout << "JIT differential tests passed (" << blocks_run << " blocks)\n";
+    return 0;
+}
@@ -0,0 +1,125 @@
+// PPU vector kernel tests.
+//
+// The frame converter and the sprite evaluator run SSE2 or AVX2 code
+// depending on the host, and
+// only the scalar kernel is simple enough to trust by reading it. Here
+// every vector level the host supports is run on the same input as the
+// scalar one and must produce the same bytes.
+
+#include <array>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "frame.hpp"
+#include "ppu.hpp"
+#include "simd.hpp"
+
+static int failures = 0;
+static std::mt19937 rng(0x2C02);
+
+static void check(bool cond, const std::string& what) {
+    if (cond) return;
+    std::cerr << "FAIL " << what << "\n";
+    failures++;
+}
+
+static const SimdLevel VECTOR_LEVELS[] = {SimdLevel::SSE2, SimdLevel::AVX2};
+
+static const char* levelName(SimdLevel level) {
+    return level == SimdLevel::AVX2 ? "AVX2" : level == SimdLevel::SSE2 ? "SSE2" : "scalar";
+}
+
+// =============================================================
+// FRAME CONVERSION
+// =============================================================
+
+// Pixels and modes use all 8 bits, so the kernels must mask them as the
+// scalar one does; every format goes through every level
+static void testConvertFrame() {
+    static const struct {
+        PixelFormat format;
+        const char* name;
+    } formats[] = {
+        {PixelFormat::ARGB8888, "ARGB8888"},
+        {PixelFormat::RGBA8888, "RGBA8888"},
+        {PixelFormat::RGB565, "RGB565"},
+        {PixelFormat::GRAY8, "GRAY8"},
+    };
+
+    for (int trial = 0; trial < 4; ++trial) {
+        IndexedFrame frame;
+        for (uint8_t& p : frame.pixels) p = static_cast<uint8_t>(rng());
+        for (uint8_t& m : frame.modes) m = static_cast<uint8_t>(rng());
+
+        for (const auto& f : formats) {
+            const std::size_t size = IndexedFrame::WIDTH * IndexedFrame::HEIGHT * bytesPerPixel(f.format);
+            std::vector<uint8_t> expected(size);
+            convertFrame(frame, f.format, expected.data(), SimdLevel::SCALAR);
+
+            for (SimdLevel level : VECTOR_LEVELS) {
+                if (!simdSupported(level)) continue;
+                std::vector<uint8_t> out(size, 0xCD);
+                convertFrame(frame, f.format, out.data(), level);
+                check(out == expected, std::string("convertFrame ") + f.name + " " + levelName(level) + " differs from scalar");
+            }
+            std::vector<uint8_t> out(size, 0xCD);
+            convertFrame(frame, f.format, out.data());
+            check(out == expected, std::string("convertFrame ") + f.name + " (host kernel) differs from scalar");
+        }
+    }
+}
+
+// =============================================================
+// SPRITE EVALUATION
+// =============================================================
+
+// Every line a byte can name at both sprite heights, against Y rows that
+// together hold all 256 values, random rows, and rows clustered around
+// the line so most sprites sit on an edge of the range
+static void testSpritesInRange() {
+    std::vector<std::array<uint8_t, 64>> rows;
+    for (int base = 0; base < 256; base += 64) {
+        std::array<uint8_t, 64> row;
+        for (int i = 0; i < 64; ++i) row[i] = static_cast<uint8_t>(base + i);
+        rows.push_back(row);
+    }
+    for (int n = 0; n < 16; ++n) {
+        std::array<uint8_t, 64> row;
+        for (uint8_t& y : row) y = static_cast<uint8_t>(rng());
+        rows.push_back(row);
+    }
+
+    alignas(32) std::array<uint8_t, 64> y;
+    for (int line = 0; line < 256; ++line) {
+        for (int height : {8, 16}) {
+            std::array<uint8_t, 64> near;
+            for (uint8_t& v : near) v = static_cast<uint8_t>(line - height - 2 + static_cast<int>(rng() % (height + 5)));
+
+            for (std::size_t r = 0; r <= rows.size(); ++r) {
+                y = r < rows.size() ? rows[r] : near;
+                const uint64_t expected = spritesInRange(y.data(), line, height, SimdLevel::SCALAR);
+                for (SimdLevel level : VECTOR_LEVELS) {
+                    if (!simdSupported(level)) continue;
+                    const uint64_t mask = spritesInRange(y.data(), line, height, level);
+                    check(mask == expected, std::string("spritesInRange ") + levelName(level) + " line " + std::to_string(line) +
+                          " height " + std::to_string(height) + " row " + std::to_string(r) + " differs from scalar");
+                }
+            }
+        }
+    }
+}
+
+int main() {
+    testConvertFrame();
+    testSpritesInRange();
+
+    if (failures) {
+        std::cerr << failures << " PPU test(s) failed\n";
+        return 1;
+    }
+    std::cout << "PPU kernel tests passed\n";
+    return 0;
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+// =============================================================
+// SIMD LEVELS
+// -----------------
+// The x86-64 vector kernels (mixer, decimator, frame conversion, sprite
+// evaluation) each pick the best level the host has once, on first use.
+// Their SimdLevel overloads run one level's kernel instead, so the tests
+// can hold every kernel to the scalar one. Levels not built for this
+// target run the scalar kernel.
+// =============================================================
+
+enum class SimdLevel {
+    SCALAR,
+    SSE2, // Part of x86-64
+    AVX2  // With FMA, which every AVX2 CPU also has
+};
+
+// Whether the host can run a level's kernels
+inline bool simdSupported(SimdLevel level) {
+#if defined(__x86_64__) && defined(__GNUC__)
+    if (level == SimdLevel::AVX2) return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    return true;
+#else
+    return level == SimdLevel::SCALAR;
+#endif
+}